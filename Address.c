@@ -0,0 +1,210 @@
+//
+// Created by yaelao on 6/16/23.
+//
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Address.h"
+
+static IntervalIndex *address_index;
+
+/**
+ * Compara dos intervalos por su base.
+ * */
+static int compare_interval(const void *data1, const void *data2) {
+    long base1 = ((Interval *) data1)->base;
+    long base2 = ((Interval *) data2)->base;
+    return (base1 > base2) - (base1 < base2);
+}
+
+/**
+ * Agrega un intervalo al final del indice.
+ * */
+static void add_interval(long base, long size, int pid) {
+    if (address_index->size == address_index->capacity) {
+        address_index->capacity *= 2;
+        address_index->intervals = (Interval *) realloc(
+                address_index->intervals, address_index->capacity * sizeof(Interval));
+        address_index->bases = (long *) realloc(
+                address_index->bases, address_index->capacity * sizeof(long));
+    }
+    address_index->intervals[address_index->size++] = (Interval) {base, base + size - 1, pid};
+}
+
+/**
+ * Reconstruye el indice con la memoria asignada actual. La tabla de bloques ya
+ * esta en orden de direccion; las asignaciones del mapa de bits se ordenan.
+ * */
+static void rebuild_index() {
+    if (address_index == NULL) {
+        address_index = (IntervalIndex *) malloc(sizeof(IntervalIndex));
+        address_index->capacity = 64;
+        address_index->intervals = (Interval *) malloc(
+                address_index->capacity * sizeof(Interval));
+        address_index->bases = (long *) malloc(address_index->capacity * sizeof(long));
+    }
+    address_index->size = 0;
+    address_index->last = 0;
+    address_index->generation = memory->generation;
+
+    if (memory->model == BITMAP_MODEL) {
+        for (int i = 0; i < memory->allocated_blocks; i++) {
+            Allocation *allocation = &memory->allocations[i];
+            add_interval(allocation->base, allocation->size, allocation->process->pid);
+        }
+        qsort(address_index->intervals, address_index->size, sizeof(Interval), compare_interval);
+    } else {
+        BlockTable *blocks = memory->blocks;
+        for (int i = blocks->head; i != NO_BLOCK; i = blocks->slots[i].next) {
+            MemoryBlock *block = block_at(blocks, i);
+            if (block->process != NULL) {
+                add_interval(block->base, block->size, block->process->pid);
+            }
+        }
+    }
+
+    for (int i = 0; i < address_index->size; i++) {
+        address_index->bases[i] = address_index->intervals[i].base;
+    }
+}
+
+/**
+ * Esta funcion busca la memoria asignada que contiene una direccion en
+ * O(log n), reconstruyendo antes el indice si la memoria cambio.
+ * @param address La direccion.
+ * @return El intervalo que contiene la direccion, NULL si la direccion esta libre.
+ * */
+Interval *find_interval(long address) {
+    if (address_index == NULL || address_index->generation != memory->generation) {
+        rebuild_index();
+    }
+    if (address_index->size == 0) {
+        return NULL;
+    }
+
+    Interval *intervals = address_index->intervals;
+    int last = address_index->last;
+    if (intervals[last].base <= address && address <= intervals[last].limit) {
+        return &intervals[last];
+    }
+
+    // El ultimo intervalo que inicia antes o en la direccion; solo se recorre el arreglo de bases.
+    long *bases = address_index->bases;
+    int low = 0, high = address_index->size;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (bases[middle] <= address) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    int first = low - 1;
+    if (first < 0 || address > intervals[first].limit) {
+        return NULL;
+    }
+    address_index->last = first;
+    return &intervals[first];
+}
+
+/**
+ * Esta funcion imprime el proceso dueño de una direccion.
+ * @param address La direccion.
+ * */
+void report_address(long address) {
+    if (address < 0 || address >= memory->total_size) {
+        printf("Address %ld is outside the memory\n", address);
+        return;
+    }
+
+    Interval *interval = find_interval(address);
+    if (interval == NULL) {
+        printf("Address %ld is free\n", address);
+    } else {
+        printf("Address %ld belongs to process %d (base %ld, limit %ld)\n", address,
+               interval->pid, interval->base, interval->limit);
+    }
+}
+
+/**
+ * Esta funcion resuelve el dueño de cada direccion de un archivo, una por linea
+ * en decimal o hexadecimal, e imprime cuantas direcciones son de cada proceso,
+ * cuantas estan libres y cuantas direcciones se resolvieron por segundo.
+ * @param path El archivo de direcciones.
+ * @return true si se leyo el archivo, false en caso contrario.
+ * */
+bool report_address_file(char *path) {
+    int fd = open(path, O_RDONLY);
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) < 0) {
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    char *data = status.st_size > 0
+                 ? mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    if (data != NULL) {
+        madvise(data, status.st_size, MADV_SEQUENTIAL);
+    }
+
+    // Se reconstruye antes de medir para contar solo las busquedas.
+    find_interval(0);
+    long *hits = (long *) calloc(address_index->size + 1, sizeof(long));
+    long addresses = 0, free_addresses = 0, outside = 0;
+    struct timespec start, finish;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    char *cursor = data, *end = data + status.st_size;
+    while (cursor < end) {
+        unsigned long address;
+        if (read_number(&cursor, end, &address)) {
+            addresses++;
+            if (address >= (unsigned long) memory->total_size) {
+                outside++;
+            } else {
+                Interval *interval = find_interval((long) address);
+                if (interval == NULL) {
+                    free_addresses++;
+                } else {
+                    hits[interval - address_index->intervals]++;
+                }
+            }
+        }
+        // El resto de la linea se ignora.
+        while (cursor < end && *cursor++ != '\n');
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    if (data != NULL) {
+        munmap(data, status.st_size);
+    }
+    double seconds = (double) (finish.tv_sec - start.tv_sec)
+                     + (finish.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("Resolved %ld addresses in %.3f s (%.0f addresses per second)\n", addresses, seconds,
+           seconds > 0 ? (double) addresses / seconds : 0.0);
+    printf("Owned: %ld, free: %ld, outside the memory: %ld\n",
+           addresses - free_addresses - outside, free_addresses, outside);
+
+    // Los procesos con mas direcciones, de mayor a menor.
+    for (int shown = 0; shown < TOP_OWNERS; shown++) {
+        int top = NOT_FOUND;
+        for (int i = 0; i < address_index->size; i++) {
+            if (hits[i] > 0 && (top == NOT_FOUND || hits[i] > hits[top])) {
+                top = i;
+            }
+        }
+        if (top == NOT_FOUND) {
+            break;
+        }
+        printf("Process %d: %ld addresses\n", address_index->intervals[top].pid, hits[top]);
+        hits[top] = 0;
+    }
+    free(hits);
+    return true;
+}
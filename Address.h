@@ -0,0 +1,50 @@
+//
+// Created by yaelao on 6/16/23.
+//
+
+#ifndef SHELL_ADDRESS_H
+#define SHELL_ADDRESS_H
+
+#include <time.h>
+#include "Memory.h"
+#include "Paging.h"
+
+// Numero de procesos que se muestran al resolver un archivo de direcciones.
+#define TOP_OWNERS 10
+
+/**
+ * Estructura que representa la memoria asignada a un proceso dentro del indice.
+ * @param base La direccion donde inicia.
+ * @param limit La ultima direccion.
+ * @param pid El proceso dueño.
+ * */
+typedef struct {
+    long base;
+    long limit;
+    int pid;
+} Interval;
+
+/**
+ * Estructura que representa el indice de direcciones: los intervalos asignados
+ * ordenados por base, para encontrar el dueño de una direccion con busqueda binaria.
+ * Se reconstruye cuando se consulta despues de que la memoria cambio.
+ * @param intervals Los intervalos ordenados por base.
+ * @param bases La base de cada intervalo; la busqueda binaria solo recorre este arreglo.
+ * @param size El numero de intervalos.
+ * @param capacity El numero de intervalos que caben en intervals.
+ * @param generation La generacion de la memoria con la que se construyo.
+ * @param last El ultimo intervalo encontrado; las direcciones cercanas se resuelven sin buscar.
+ * */
+typedef struct {
+    Interval *intervals;
+    long *bases;
+    int size;
+    int capacity;
+    long generation;
+    int last;
+} IntervalIndex;
+
+Interval *find_interval(long address);
+void report_address(long address);
+bool report_address_file(char *path);
+#endif //SHELL_ADDRESS_H
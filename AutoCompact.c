@@ -0,0 +1,206 @@
+//
+// Created by yaelao on 6/17/23.
+//
+
+#include "AutoCompact.h"
+
+AutoCompaction *auto_compaction;
+
+/**
+ * Esta funcion activa la compactacion automatica, o cambia sus umbrales si ya
+ * estaba activa.
+ * @param fragmentation El umbral de fragmentacion externa, entre 0 y 1.
+ * @param failure_rate El umbral de la tasa de fallos de asignacion, entre 0 y 1.
+ * @param budget El tiempo maximo de cada paso, en microsegundos.
+ * */
+void enable_auto_compaction(double fragmentation, double failure_rate, long budget) {
+    if (auto_compaction == NULL) {
+        auto_compaction = (AutoCompaction *) calloc(1, sizeof(AutoCompaction));
+        auto_compaction->generation = -1;
+    }
+    auto_compaction->fragmentation = fragmentation;
+    auto_compaction->failure_rate = failure_rate;
+    auto_compaction->budget = budget;
+}
+
+/**
+ * Esta funcion desactiva la compactacion automatica. La memoria queda valida
+ * aunque haya una compactacion a medias.
+ * */
+void disable_auto_compaction() {
+    free(auto_compaction);
+    auto_compaction = NULL;
+}
+
+/**
+ * Obtiene los microsegundos transcurridos desde un instante.
+ * */
+static double elapsed_since(struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start->tv_sec) * 1e6 + (now.tv_nsec - start->tv_nsec) / 1e3;
+}
+
+/**
+ * Mueve el primer bloque asignado que tiene un hueco libre antes: el proceso
+ * pasa al inicio del hueco y el hueco queda despues del proceso, donde se une
+ * con el bloque libre siguiente. Como nunca hay dos bloques libres juntos, el
+ * bloque que sigue a un hueco siempre esta asignado.
+ * @return true si se movio un bloque, false si la memoria ya esta compactada.
+ * */
+static bool move_next_block() {
+    BlockTable *blocks = memory->blocks;
+    int hole = auto_compaction->generation == memory->generation
+               ? auto_compaction->cursor : blocks->head;
+
+    while (hole != NO_BLOCK && blocks->slots[hole].process != NULL) {
+        hole = blocks->slots[hole].next;
+    }
+    if (hole == NO_BLOCK || blocks->slots[hole].next == NO_BLOCK) {
+        return false;
+    }
+
+    // El hueco toma el proceso y el bloque del proceso queda libre.
+    int moved = blocks->slots[hole].next;
+    MemoryBlock *target = block_at(blocks, hole), *source = block_at(blocks, moved);
+    long hole_size = target->size;
+    if (memory->backing != NULL) {
+        move_region(memory->backing, source->base, target->base, source->process->size);
+    }
+    unindex_free_block(hole);
+    target->size = source->size;
+    target->process = source->process;
+    source->base = target->base + target->size;
+    source->size = hole_size;
+    source->process = NULL;
+    hash_put(memory->owners, target->process->pid, hole);
+
+    auto_compaction->moved_units += target->size;
+    auto_compaction->moved_blocks++;
+    memory->relocated_units += target->size;
+    memory->relocated_blocks++;
+
+    auto_compaction->cursor = coalesce_block(moved);
+    auto_compaction->generation = memory->generation;
+    return true;
+}
+
+/**
+ * Compara dos asignaciones por su base.
+ * */
+static int compare_base(const void *data1, const void *data2) {
+    long base1 = ((Allocation *) data1)->base;
+    long base2 = ((Allocation *) data2)->base;
+    return (base1 > base2) - (base1 < base2);
+}
+
+/**
+ * Mueve la siguiente asignacion del mapa de bits, en orden de direccion, al
+ * final de la parte ya compactada. Al iniciar, o si la memoria cambio, las
+ * asignaciones se ordenan por base.
+ * @return true si se movio una asignacion, false si la memoria ya esta compactada.
+ * */
+static bool move_next_allocation() {
+    Allocation *allocations = memory->allocations;
+    int count = memory->allocated_blocks;
+
+    if (auto_compaction->generation != memory->generation) {
+        qsort(allocations, count, sizeof(Allocation), compare_base);
+        for (int i = 0; i < count; i++) {
+            hash_put(memory->owners, allocations[i].process->pid, i);
+        }
+        auto_compaction->cursor = 0;
+        auto_compaction->packed = 0;
+    }
+
+    // Las asignaciones que ya estan en su lugar no cuestan nada.
+    int i = auto_compaction->cursor;
+    while (i < count && allocations[i].base == auto_compaction->packed) {
+        auto_compaction->packed += allocations[i++].size;
+    }
+    auto_compaction->cursor = i;
+    auto_compaction->generation = memory->generation;
+    if (i == count) {
+        return false;
+    }
+
+    long unit_size = memory->unit_size, bits = allocations[i].size / unit_size;
+    if (memory->backing != NULL) {
+        move_region(memory->backing, allocations[i].base, auto_compaction->packed,
+                    allocations[i].process->size);
+    }
+    bitmap_clear_run(memory->bitmap, allocations[i].base / unit_size, bits);
+    bitmap_set_run(memory->bitmap, auto_compaction->packed / unit_size, bits);
+    allocations[i].base = auto_compaction->packed;
+    auto_compaction->packed += allocations[i].size;
+    auto_compaction->cursor = i + 1;
+
+    auto_compaction->moved_units += allocations[i].size;
+    auto_compaction->moved_blocks++;
+    memory->relocated_units += allocations[i].size;
+    memory->relocated_blocks++;
+    memory->generation++;
+    auto_compaction->generation = memory->generation;
+    return true;
+}
+
+/**
+ * Esta funcion ejecuta un paso de la compactacion automatica. Si no hay una
+ * compactacion en curso, inicia una cuando la fragmentacion o la tasa de fallos
+ * alcanzan su umbral. Cada paso mueve bloques hasta agotar el presupuesto de
+ * tiempo, asi que ningun paso detiene el shell por mucho tiempo.
+ * */
+void auto_compact_step() {
+    // Mover un bloque buddy rompe su alineacion.
+    if (auto_compaction == NULL || memory->mode == BUDDY_MODE) {
+        return;
+    }
+
+    if (!auto_compaction->running) {
+        /* Los fallos solo cuentan si la ultima asignacion fallida cabria en la
+         * memoria libre juntando los huecos; si no, compactar no sirve. */
+        double fragmentation = external_fragmentation();
+        bool failing = memory->failure_rate >= auto_compaction->failure_rate
+                       && memory->failed_size <= memory->remaining_size;
+        if (fragmentation == 0.0 || (fragmentation < auto_compaction->fragmentation && !failing)) {
+            return;
+        }
+        auto_compaction->running = true;
+        auto_compaction->generation = -1;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    double elapsed;
+    do {
+        bool moved = memory->model == BITMAP_MODEL ? move_next_allocation() : move_next_block();
+        elapsed = elapsed_since(&start);
+        if (!moved) {
+            auto_compaction->running = false;
+            auto_compaction->runs++;
+            break;
+        }
+    } while (elapsed < (double) auto_compaction->budget);
+
+    auto_compaction->steps++;
+    if (elapsed > auto_compaction->longest_step) {
+        auto_compaction->longest_step = elapsed;
+    }
+}
+
+/**
+ * Esta funcion imprime la configuracion y el trabajo de la compactacion automatica.
+ * */
+void report_auto_compaction() {
+    if (auto_compaction == NULL) {
+        printf("Auto compaction is off\n");
+        return;
+    }
+    printf("Auto compaction at fragmentation %.2f or failure rate %.2f, %ld us per step\n",
+           auto_compaction->fragmentation, auto_compaction->failure_rate, auto_compaction->budget);
+    printf("Fragmentation %.4f, failure rate %.4f, %s\n", external_fragmentation(),
+           memory->failure_rate, auto_compaction->running ? "compacting" : "idle");
+    printf("Runs: %ld, steps: %ld, moved %ld units in %ld blocks, longest step %.0f us\n",
+           auto_compaction->runs, auto_compaction->steps, auto_compaction->moved_units,
+           auto_compaction->moved_blocks, auto_compaction->longest_step);
+}
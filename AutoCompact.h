@@ -0,0 +1,55 @@
+//
+// Created by yaelao on 6/17/23.
+//
+
+#ifndef SHELL_AUTOCOMPACT_H
+#define SHELL_AUTOCOMPACT_H
+
+#include <time.h>
+#include "Memory.h"
+
+// Tiempo maximo de cada paso de compactacion si no se indica otro, en microsegundos.
+#define DEFAULT_COMPACTION_BUDGET 1000L
+
+/**
+ * Estructura que representa la compactacion automatica. Cuando la fragmentacion
+ * externa o la tasa de fallos reciente alcanzan su umbral, la memoria se compacta
+ * hacia la direccion 0 en pasos que mueven bloques hasta agotar el presupuesto de
+ * tiempo; los pasos se ejecutan entre comandos y entre ticks del planificador.
+ * @param fragmentation El umbral de fragmentacion externa.
+ * @param failure_rate El umbral de la tasa de fallos de asignacion.
+ * @param budget El tiempo maximo de cada paso, en microsegundos.
+ * @param running true si hay una compactacion en curso.
+ * @param cursor El bloque libre (BLOCK_MODEL) o la asignacion (BITMAP_MODEL)
+ * donde sigue la compactacion.
+ * @param packed La direccion hasta donde la memoria ya esta compactada (BITMAP_MODEL).
+ * @param generation La generacion de la memoria despues del ultimo movimiento; si
+ * la memoria cambio desde entonces, el cursor ya no sirve.
+ * @param runs El numero de compactaciones terminadas.
+ * @param steps El numero de pasos ejecutados.
+ * @param moved_units El total de unidades movidas.
+ * @param moved_blocks El total de bloques movidos.
+ * @param longest_step La duracion del paso mas largo, en microsegundos.
+ * */
+typedef struct {
+    double fragmentation;
+    double failure_rate;
+    long budget;
+    bool running;
+    int cursor;
+    long packed;
+    long generation;
+    long runs;
+    long steps;
+    long moved_units;
+    long moved_blocks;
+    double longest_step;
+} AutoCompaction;
+
+extern AutoCompaction *auto_compaction;
+
+void enable_auto_compaction(double fragmentation, double failure_rate, long budget);
+void disable_auto_compaction();
+void auto_compact_step();
+void report_auto_compaction();
+#endif //SHELL_AUTOCOMPACT_H
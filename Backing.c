@@ -0,0 +1,322 @@
+//
+// Created by yaelao on 6/19/23.
+//
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "Backing.h"
+#include "Memory.h"
+
+bool backing_enabled;
+
+/**
+ * Obtiene los segundos transcurridos desde un instante.
+ * */
+static double seconds_since(struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * Obtiene la palabra k del patron de un proceso. Cada palabra es distinta, asi
+ * que un byte copiado al lugar equivocado tambien se detecta.
+ * */
+static inline uint64_t pattern_word(uint64_t seed, long k) {
+    return seed + (uint64_t) k * 0x9E3779B97F4A7C15ULL;
+}
+
+/**
+ * Obtiene el byte del patron de un proceso en una posicion de su memoria.
+ * */
+static inline unsigned char pattern_byte(uint64_t seed, long offset) {
+    return (unsigned char) (pattern_word(seed, offset / 8) >> (offset % 8 * 8));
+}
+
+/**
+ * Obtiene la semilla del patron de un proceso.
+ * */
+static inline uint64_t pattern_seed(Process *process) {
+    return ((uint64_t) (uint32_t) process->pid << 32) ^ 0xD1B54A32D192ED03ULL;
+}
+
+/**
+ * Esta funcion mapea el buffer de una memoria. Las paginas se reservan hasta
+ * que se escriben, asi que una memoria grande casi vacia cuesta poco.
+ * @param size El tamaño de la memoria, en bytes.
+ * @return El buffer, NULL si no se pudo mapear.
+ * */
+Backing *create_backing(long size) {
+    void *bytes = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (bytes == MAP_FAILED) {
+        return NULL;
+    }
+    Backing *backing = (Backing *) calloc(1, sizeof(Backing));
+    backing->bytes = (unsigned char *) bytes;
+    backing->size = size;
+    backing->page_size = sysconf(_SC_PAGESIZE);
+    return backing;
+}
+
+/**
+ * Esta funcion libera el buffer de una memoria.
+ * */
+void release_backing(Backing *backing) {
+    if (backing == NULL) {
+        return;
+    }
+    munmap(backing->bytes, backing->size);
+    free(backing);
+}
+
+/**
+ * Esta funcion escribe el patron de un proceso en una parte de su memoria.
+ * @param backing El buffer.
+ * @param process El proceso.
+ * @param base La direccion donde inicia la memoria del proceso.
+ * @param from La primera posicion a escribir, relativa a base.
+ * @param to La posicion donde termina la escritura, relativa a base.
+ * */
+void fill_region(Backing *backing, Process *process, long base, long from, long to) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    unsigned char *region = backing->bytes + base;
+    uint64_t seed = pattern_seed(process);
+
+    long offset = from;
+    for (; offset < to && offset % 8 != 0; offset++) {
+        region[offset] = pattern_byte(seed, offset);
+    }
+    for (; offset + 8 <= to; offset += 8) {
+        uint64_t word = pattern_word(seed, offset / 8);
+        memcpy(region + offset, &word, sizeof(word));
+    }
+    for (; offset < to; offset++) {
+        region[offset] = pattern_byte(seed, offset);
+    }
+
+    backing->filled_bytes += to - from;
+    backing->fill_seconds += seconds_since(&start);
+}
+
+/**
+ * Mueve con mremap las paginas completas de una copia sin traslape cuya
+ * distancia es multiplo del tamaño de pagina; los bytes de las orillas se copian.
+ * La pagina de origen se reemplaza por una pagina nueva sin contenido. Si no se
+ * puede mapear, el buffer queda con un hueco y se marca como fallido.
+ * @return true si se movio la copia, false si no se puede remapear.
+ * */
+static bool remap_region(Backing *backing, long from, long to, long size) {
+    long page = backing->page_size, distance = to - from;
+    long first = (from + page - 1) / page * page, last = (from + size) / page * page;
+    if (distance % page != 0 || labs(distance) < size || last - first < REMAP_MIN_BYTES) {
+        return false;
+    }
+
+    unsigned char *bytes = backing->bytes;
+    void *moved = mremap(bytes + first, last - first, last - first,
+                         MREMAP_MAYMOVE | MREMAP_FIXED, bytes + first + distance);
+    if (moved == MAP_FAILED) {
+        return false;
+    }
+    void *refilled = mmap(bytes + first, last - first, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+    if (refilled == MAP_FAILED) {
+        backing->failed = true;
+        return true;
+    }
+    memcpy(bytes + to, bytes + from, first - from);
+    memcpy(bytes + last + distance, bytes + last, from + size - last);
+    backing->remapped_bytes += last - first;
+    return true;
+}
+
+/**
+ * Esta funcion mueve los bytes de un proceso que se reubica. El origen y el
+ * destino se pueden traslapar. Si el buffer queda con un hueco, la memoria deja
+ * de tener bytes reales.
+ * @param backing El buffer, NULL si la memoria ya no tiene bytes reales.
+ * @param from La direccion donde estaba el proceso.
+ * @param to La nueva direccion del proceso.
+ * @param size El numero de bytes a mover.
+ * */
+void move_region(Backing *backing, long from, long to, long size) {
+    if (backing == NULL || from == to || size <= 0) {
+        return;
+    }
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (!remap_region(backing, from, to, size)) {
+        memmove(backing->bytes + to, backing->bytes + from, size);
+    }
+    if (backing->failed) {
+        printf("Could not map the memory bytes after a move, disabling them\n");
+        disable_backing();
+        return;
+    }
+    backing->copied_bytes += size;
+    backing->copies++;
+    backing->copy_seconds += seconds_since(&start);
+}
+
+/**
+ * Esta funcion compara la memoria de un proceso con su patron.
+ * @param backing El buffer.
+ * @param process El proceso.
+ * @param base La direccion donde inicia la memoria del proceso.
+ * @return La primera posicion que no coincide, -1 si toda coincide.
+ * */
+long verify_region(Backing *backing, Process *process, long base) {
+    unsigned char *region = backing->bytes + base;
+    uint64_t seed = pattern_seed(process);
+    long offset = 0, size = process->size;
+
+    for (; offset < size && offset % 8 != 0; offset++) {
+        if (region[offset] != pattern_byte(seed, offset)) {
+            return offset;
+        }
+    }
+    for (; offset + 8 <= size; offset += 8) {
+        uint64_t word;
+        memcpy(&word, region + offset, sizeof(word));
+        if (word != pattern_word(seed, offset / 8)) {
+            break;
+        }
+    }
+    for (; offset < size; offset++) {
+        if (region[offset] != pattern_byte(seed, offset)) {
+            return offset;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Obtiene la memoria de cada proceso con memoria asignada, en orden de direccion
+ * en el modelo de bloques. El tamaño de cada una es el del proceso.
+ * @param count Donde se guarda el numero de procesos.
+ * */
+static Allocation *process_regions(int *count) {
+    Allocation *regions = (Allocation *) malloc((memory->allocated_blocks + 1) * sizeof(Allocation));
+    *count = 0;
+    if (memory->model == BITMAP_MODEL) {
+        for (int i = 0; i < memory->allocated_blocks; i++) {
+            Allocation *allocation = &memory->allocations[i];
+            regions[(*count)++] = (Allocation) {
+                    allocation->base, allocation->process->size, allocation->process
+            };
+        }
+        return regions;
+    }
+    BlockTable *blocks = memory->blocks;
+    for (int i = blocks->head; i != NO_BLOCK; i = blocks->slots[i].next) {
+        MemoryBlock *block = block_at(blocks, i);
+        if (block->process != NULL) {
+            regions[(*count)++] = (Allocation) {block->base, block->process->size, block->process};
+        }
+    }
+    return regions;
+}
+
+/**
+ * Esta funcion escribe el patron de cada proceso con memoria asignada.
+ * */
+void fill_backing() {
+    int count;
+    Allocation *regions = process_regions(&count);
+    for (int i = 0; i < count; i++) {
+        fill_region(memory->backing, regions[i].process, regions[i].base, 0, regions[i].size);
+    }
+    free(regions);
+}
+
+/**
+ * Esta funcion activa los bytes reales: la memoria actual y las que se
+ * inicialicen despues tienen un buffer, y los procesos que ya tienen memoria
+ * reciben su patron.
+ * @return true si se pudo mapear el buffer, false en caso contrario.
+ * */
+bool enable_backing() {
+    backing_enabled = true;
+    if (memory->backing != NULL) {
+        return true;
+    }
+    memory->backing = create_backing(memory->total_size);
+    if (memory->backing == NULL) {
+        backing_enabled = false;
+        return false;
+    }
+    fill_backing();
+    return true;
+}
+
+/**
+ * Esta funcion desactiva los bytes reales y libera el buffer de la memoria actual.
+ * */
+void disable_backing() {
+    backing_enabled = false;
+    release_backing(memory->backing);
+    memory->backing = NULL;
+}
+
+/**
+ * Esta funcion compara la memoria de cada proceso con su patron e imprime
+ * cuantos procesos la conservan intacta.
+ * */
+void verify_backing() {
+    if (memory->backing == NULL) {
+        printf("The memory has no backing bytes, use backing on\n");
+        return;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int count, corrupted = 0;
+    long bytes = 0;
+    Allocation *regions = process_regions(&count);
+    for (int i = 0; i < count; i++) {
+        long offset = verify_region(memory->backing, regions[i].process, regions[i].base);
+        bytes += regions[i].size;
+        if (offset >= 0) {
+            if (corrupted++ == 0) {
+                printf("Process %d differs from its pattern at address %ld\n",
+                       regions[i].process->pid, regions[i].base + offset);
+            }
+        }
+    }
+    free(regions);
+    double seconds = seconds_since(&start);
+
+    printf("Verified %d processes (%ld bytes) in %.3f ms: %s", count, bytes, seconds * 1e3,
+           corrupted == 0 ? "all intact\n" : "");
+    if (corrupted > 0) {
+        printf("%d corrupted\n", corrupted);
+    }
+}
+
+/**
+ * Obtiene un ritmo en GB/s.
+ * */
+static double bandwidth(long bytes, double seconds) {
+    return seconds > 0 ? (double) bytes / seconds / 1e9 : 0.0;
+}
+
+/**
+ * Esta funcion imprime el trabajo hecho sobre los bytes reales de la memoria.
+ * */
+void report_backing() {
+    Backing *backing = memory->backing;
+    if (backing == NULL) {
+        printf("The memory has no backing bytes\n");
+        return;
+    }
+    printf("Backing buffer of %ld bytes (%ld byte pages)\n", backing->size, backing->page_size);
+    printf("Filled %ld bytes in %.3f ms (%.2f GB/s)\n", backing->filled_bytes,
+           backing->fill_seconds * 1e3, bandwidth(backing->filled_bytes, backing->fill_seconds));
+    printf("Moved %ld bytes in %ld relocations in %.3f ms (%.2f GB/s), %ld bytes remapped\n",
+           backing->copied_bytes, backing->copies, backing->copy_seconds * 1e3,
+           bandwidth(backing->copied_bytes, backing->copy_seconds), backing->remapped_bytes);
+}
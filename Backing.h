@@ -0,0 +1,58 @@
+//
+// Created by yaelao on 6/19/23.
+//
+
+#ifndef SHELL_BACKING_H
+#define SHELL_BACKING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "Process.h"
+
+// Las copias de al menos REMAP_MIN_BYTES alineadas a pagina se mueven con mremap.
+#define REMAP_MIN_BYTES (256L * 1024)
+
+/**
+ * Estructura que representa los bytes reales de la memoria simulada: un
+ * buffer mapeado de total_size bytes donde cada proceso tiene un patron que
+ * depende de su pid, para que mover bloques cueste lo que cuesta copiarlos y
+ * se pueda verificar que ningun byte se perdio.
+ * @param bytes El buffer, una unidad por byte.
+ * @param size El tamaño del buffer.
+ * @param page_size El tamaño de pagina del sistema.
+ * @param filled_bytes El total de bytes escritos con el patron de un proceso.
+ * @param copied_bytes El total de bytes movidos al reubicar procesos.
+ * @param remapped_bytes Los bytes movidos que se remapearon en lugar de copiarse.
+ * @param copies El numero de reubicaciones.
+ * @param fill_seconds El tiempo escribiendo patrones.
+ * @param copy_seconds El tiempo moviendo bytes.
+ * @param failed Si parte del buffer quedo sin mapear y ya no se puede usar.
+ * */
+typedef struct {
+    unsigned char *bytes;
+    long size;
+    long page_size;
+    long filled_bytes;
+    long copied_bytes;
+    long remapped_bytes;
+    long copies;
+    double fill_seconds;
+    double copy_seconds;
+    bool failed;
+} Backing;
+
+// Si esta activo, cada memoria que se inicializa tiene sus bytes reales.
+extern bool backing_enabled;
+
+Backing *create_backing(long size);
+void release_backing(Backing *backing);
+void fill_region(Backing *backing, Process *process, long base, long from, long to);
+void move_region(Backing *backing, long from, long to, long size);
+long verify_region(Backing *backing, Process *process, long base);
+bool enable_backing();
+void disable_backing();
+void fill_backing();
+void verify_backing();
+void report_backing();
+#endif //SHELL_BACKING_H
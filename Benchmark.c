@@ -0,0 +1,181 @@
+//
+// Created by yaelao on 6/7/23.
+//
+
+/* Benchmark que compara el recorrido de la tabla de bloques contra
+ * la representacion anterior (una List con un MemoryBlock por nodo).
+ * Uso: ./Benchmark [numero de bloques...] */
+
+#include <time.h>
+#include "List.h"
+#include "Table.h"
+
+/**
+ * Copia de la estructura de bloque que se guardaba en cada nodo de la lista.
+ * */
+typedef struct {
+    int size;
+    int remaining_size;
+    int base;
+    int limit;
+    Process *process;
+} ListBlock;
+
+static double now_ms() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1e3 + time.tv_nsec / 1e6;
+}
+
+/**
+ * Agrega un nodo despues del nodo indicado en O(1).
+ * @param list La lista a la que se le agregara el nodo.
+ * @param node El nodo despues del cual se agregara el nuevo nodo.
+ * @param data El dato que contendra el nodo.
+ * @param type_size El tamaño del tipo de dato que contendra el nodo.
+ * @return El nodo agregado.
+ * */
+static Node *insert_after(List *list, Node *node, void *data, size_t type_size) {
+    Node *inserted = create_node_list(type_size);
+    memcpy(inserted->data, data, type_size);
+
+    inserted->next = node->next;
+    node->next = (struct Node *) inserted;
+    if (node == list->tail) {
+        list->tail = inserted;
+    }
+    list->size++;
+    return inserted;
+}
+
+/**
+ * Construye ambas representaciones con el mismo patron: cada bloque nuevo
+ * se inserta despues de un bloque existente elegido al azar, como ocurre
+ * al dividir bloques, y uno de cada dos bloques queda ocupado.
+ * */
+static void build(int num_blocks, List *list, BlockTable *table) {
+    static Process process = {.pid = 1, .size = 1};
+    Node **nodes = (Node **) malloc(num_blocks * sizeof(Node *));
+    ListBlock data = {0};
+
+    append(list, &data, sizeof(ListBlock));
+    nodes[0] = list->head;
+    table_insert_after(table, NO_BLOCK);
+
+    for (int i = 1; i < num_blocks; i++) {
+        int after = rand() % i;
+        nodes[i] = insert_after(list, nodes[after], &data, sizeof(ListBlock));
+        table_insert_after(table, after);
+    }
+
+    int base = 0, number = 0;
+    for (Node *node = list->head; node != NULL; node = (Node *) node->next, number++) {
+        ListBlock *block = (ListBlock *) node->data;
+        block->base = base;
+        block->size = 1;
+        block->limit = base;
+        block->remaining_size = number % 2 == 0 ? 1 : 0;
+        block->process = number % 2 == 0 ? NULL : &process;
+        base++;
+    }
+
+    base = 0, number = 0;
+    for (int i = table->head; i != NO_BLOCK; i = table->slots[i].next, number++) {
+        table->slots[i].base = base++;
+        table->slots[i].size = 1;
+        table->slots[i].process = number % 2 == 0 ? NULL : &process;
+    }
+    free(nodes);
+}
+
+/* Cada recorrido busca un bloque libre mas grande que cualquiera,
+ * de modo que visita todos los bloques como lo hace first fit al fallar. */
+
+static long scan_get_at(List *list) {
+    long found = 0;
+    for (int i = 0; i < list->size; i++) {
+        ListBlock *block = (ListBlock *) get_at(list, i);
+        found += block->process == NULL && block->remaining_size > 1;
+    }
+    return found;
+}
+
+static long scan_list(List *list) {
+    long found = 0;
+    for (Node *node = list->head; node != NULL; node = (Node *) node->next) {
+        ListBlock *block = (ListBlock *) node->data;
+        found += block->process == NULL && block->remaining_size > 1;
+    }
+    return found;
+}
+
+static long scan_table(BlockTable *table) {
+    long found = 0;
+    for (int i = table->head; i != NO_BLOCK; i = table->slots[i].next) {
+        MemoryBlock *block = &table->slots[i];
+        found += block->process == NULL && block->size > 1;
+    }
+    return found;
+}
+
+/**
+ * Mide el tiempo promedio por bloque de un recorrido.
+ * @return Nanosegundos por bloque.
+ * */
+static double measure(long (*scan)(void *), void *blocks, int num_blocks, int repetitions) {
+    long found = 0;
+    double start = now_ms();
+    for (int i = 0; i < repetitions; i++) {
+        found += scan(blocks);
+    }
+    double elapsed = now_ms() - start;
+    if (found != 0) {
+        printf("unexpected match\n");
+    }
+    return elapsed * 1e6 / ((double) num_blocks * repetitions);
+}
+
+static void run(int num_blocks) {
+    List *list = create_list();
+    BlockTable *table = create_table(64);
+    build(num_blocks, list, table);
+
+    int repetitions = num_blocks >= 10000000 ? 1 : 10000000 / num_blocks;
+    double list_ns = measure((long (*)(void *)) scan_list, list, num_blocks, repetitions);
+    double table_ns = measure((long (*)(void *)) scan_table, table, num_blocks, repetitions);
+    // Despues de compactar la tabla queda en orden de direccion.
+    table_repack(table);
+    double packed_ns = measure((long (*)(void *)) scan_table, table, num_blocks, repetitions);
+
+    // Con get_at el recorrido es cuadratico; solo se mide con pocos bloques.
+    if (num_blocks <= 20000) {
+        double get_at_ns = measure((long (*)(void *)) scan_get_at, list, num_blocks, 1);
+        printf("%10d %14.2f %14.2f %14.2f %14.2f %9.1fx %9.1fx\n", num_blocks, get_at_ns,
+               list_ns, table_ns, packed_ns, get_at_ns / packed_ns, list_ns / packed_ns);
+    } else {
+        printf("%10d %14s %14.2f %14.2f %14.2f %10s %9.1fx\n", num_blocks, "-",
+               list_ns, table_ns, packed_ns, "-", list_ns / packed_ns);
+    }
+
+    clear_list(list);
+    clear_table(table);
+}
+
+int main(int argc, char *argv[]) {
+    srand(42);
+    printf("Scan cost per block (ns)\n");
+    printf("%10s %14s %14s %14s %14s %10s %10s\n", "Blocks", "List get_at",
+           "List walk", "Table walk", "Table packed", "vs get_at", "vs walk");
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            run(atoi(argv[i]));
+        }
+        return 0;
+    }
+
+    run(10000);
+    run(100000);
+    run(1000000);
+    return 0;
+}
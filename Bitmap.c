@@ -0,0 +1,162 @@
+//
+// Created by yaelao on 6/10/23.
+//
+
+#include "Bitmap.h"
+
+/**
+ * Crea un mapa de bits con todos los bits apagados.
+ * Los bits de la ultima palabra que quedan fuera del mapa se encienden
+ * para que nunca se consideren libres.
+ * @param size El numero de bits del mapa.
+ * @return El mapa creado.
+ * */
+Bitmap *create_bitmap(long size) {
+    Bitmap *bitmap = (Bitmap *) malloc(sizeof(Bitmap));
+    bitmap->size = size;
+    bitmap->num_words = (size + WORD_BITS - 1) / WORD_BITS;
+    bitmap->words = (uint64_t *) calloc(bitmap->num_words + 1, sizeof(uint64_t));
+
+    long tail = size % WORD_BITS;
+    if (tail != 0) {
+        bitmap->words[bitmap->num_words - 1] = ~0UL << tail;
+    }
+    // Palabra centinela: todas las unidades despues del final estan ocupadas.
+    bitmap->words[bitmap->num_words] = ~0UL;
+    return bitmap;
+}
+
+/**
+ * Comprueba si un bit esta encendido.
+ * */
+bool bitmap_test(Bitmap *bitmap, long bit) {
+    return (bitmap->words[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+}
+
+/**
+ * Busca el siguiente bit apagado a partir de una posicion,
+ * saltando de 64 en 64 las palabras llenas.
+ * @param bitmap El mapa.
+ * @param from La posicion donde inicia la busqueda.
+ * @return La posicion del bit, o el tamaño del mapa si no hay ninguno.
+ * */
+long bitmap_next_clear(Bitmap *bitmap, long from) {
+    if (from >= bitmap->size) {
+        return bitmap->size;
+    }
+
+    long index = from / WORD_BITS;
+    uint64_t word = ~bitmap->words[index] & (~0UL << (from % WORD_BITS));
+    while (word == 0) {
+        if (++index >= bitmap->num_words) {
+            return bitmap->size;
+        }
+        word = ~bitmap->words[index];
+    }
+    long bit = index * WORD_BITS + __builtin_ctzl(word);
+    return bit < bitmap->size ? bit : bitmap->size;
+}
+
+/**
+ * Busca el siguiente bit encendido a partir de una posicion,
+ * saltando de 64 en 64 las palabras vacias.
+ * @param bitmap El mapa.
+ * @param from La posicion donde inicia la busqueda.
+ * @return La posicion del bit, o el tamaño del mapa si no hay ninguno.
+ * */
+long bitmap_next_set(Bitmap *bitmap, long from) {
+    if (from >= bitmap->size) {
+        return bitmap->size;
+    }
+
+    // La palabra centinela garantiza que la busqueda termina.
+    long index = from / WORD_BITS;
+    uint64_t word = bitmap->words[index] & (~0UL << (from % WORD_BITS));
+    while (word == 0) {
+        word = bitmap->words[++index];
+    }
+    long bit = index * WORD_BITS + __builtin_ctzl(word);
+    return bit < bitmap->size ? bit : bitmap->size;
+}
+
+/**
+ * Busca la primera secuencia de bits apagados de la longitud indicada.
+ * Cada palabra se revisa a lo mas una vez, por lo que la busqueda
+ * cuesta O(size / 64) sin importar cuantas secuencias haya.
+ * @param bitmap El mapa.
+ * @param length La longitud de la secuencia.
+ * @param from La posicion donde inicia la busqueda.
+ * @return La posicion donde inicia la secuencia, -1 si no existe.
+ * */
+long bitmap_find_run(Bitmap *bitmap, long length, long from) {
+    long start = bitmap_next_clear(bitmap, from);
+
+    while (start + length <= bitmap->size) {
+        long end = bitmap_next_set(bitmap, start);
+        if (end - start >= length) {
+            return start;
+        }
+        start = bitmap_next_clear(bitmap, end);
+    }
+    return -1;
+}
+
+/**
+ * Aplica una mascara a las palabras que cubren una secuencia de bits.
+ * @param set true para encender los bits, false para apagarlos.
+ * */
+static void apply_run(Bitmap *bitmap, long start, long length, bool set) {
+    long end = start + length;
+    long first = start / WORD_BITS, last = (end - 1) / WORD_BITS;
+    uint64_t first_mask = ~0UL << (start % WORD_BITS);
+    uint64_t last_mask = ~0UL >> ((WORD_BITS - end % WORD_BITS) % WORD_BITS);
+
+    if (first == last) {
+        first_mask &= last_mask;
+    }
+    if (set) {
+        bitmap->words[first] |= first_mask;
+    } else {
+        bitmap->words[first] &= ~first_mask;
+    }
+    if (first == last) {
+        return;
+    }
+
+    // Las palabras intermedias se llenan completas.
+    if (last - first > 1) {
+        memset(&bitmap->words[first + 1], set ? 0xFF : 0,
+               (last - first - 1) * sizeof(uint64_t));
+    }
+    if (set) {
+        bitmap->words[last] |= last_mask;
+    } else {
+        bitmap->words[last] &= ~last_mask;
+    }
+}
+
+/**
+ * Enciende una secuencia de bits (marca las unidades como ocupadas).
+ * */
+void bitmap_set_run(Bitmap *bitmap, long start, long length) {
+    if (length > 0) {
+        apply_run(bitmap, start, length, true);
+    }
+}
+
+/**
+ * Apaga una secuencia de bits (marca las unidades como libres).
+ * */
+void bitmap_clear_run(Bitmap *bitmap, long start, long length) {
+    if (length > 0) {
+        apply_run(bitmap, start, length, false);
+    }
+}
+
+/**
+ * Libera la memoria reservada para el mapa.
+ * */
+void clear_bitmap(Bitmap *bitmap) {
+    free(bitmap->words);
+    free(bitmap);
+}
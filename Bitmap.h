@@ -0,0 +1,36 @@
+//
+// Created by yaelao on 6/10/23.
+//
+
+#ifndef SHELL_BITMAP_H
+#define SHELL_BITMAP_H
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Numero de bits en cada palabra del mapa.
+#define WORD_BITS 64
+
+/**
+ * Estructura que representa un mapa de bits; un bit encendido es una unidad ocupada.
+ * @param words Las palabras de 64 bits del mapa.
+ * @param size El numero de bits del mapa.
+ * @param num_words El numero de palabras del mapa.
+ * */
+typedef struct {
+    uint64_t *words;
+    long size;
+    long num_words;
+} Bitmap;
+
+Bitmap *create_bitmap(long size);
+void clear_bitmap(Bitmap *bitmap);
+bool bitmap_test(Bitmap *bitmap, long bit);
+long bitmap_next_clear(Bitmap *bitmap, long from);
+long bitmap_next_set(Bitmap *bitmap, long from);
+long bitmap_find_run(Bitmap *bitmap, long length, long from);
+void bitmap_set_run(Bitmap *bitmap, long start, long length);
+void bitmap_clear_run(Bitmap *bitmap, long start, long length);
+#endif //SHELL_BITMAP_H
@@ -0,0 +1,169 @@
+//
+// Created by yaelao on 6/8/23.
+//
+
+#include "Buddy.h"
+
+/**
+ * Obtiene el orden del menor bloque buddy donde cabe un tamaño,
+ * es decir, el menor k tal que 2^k >= size.
+ * @param size El tamaño a acomodar.
+ * @return El orden del bloque.
+ * */
+int buddy_order(long size) {
+    return size <= 1 ? 0 : 64 - __builtin_clzl((unsigned long) size - 1);
+}
+
+/**
+ * Divide la memoria en los bloques buddy iniciales: los mayores bloques
+ * de potencias de dos alineados a su tamaño que cubren la memoria.
+ * */
+void buddy_layout() {
+    long base = 0;
+    int previous = NO_BLOCK;
+
+    while (base < memory->total_size) {
+        int order = base == 0 ? BUDDY_ORDERS - 1 : __builtin_ctzl((unsigned long) base);
+        while ((1UL << order) > (unsigned long) (memory->total_size - base)) {
+            order--;
+        }
+        previous = make_memory_block(previous, base, 1L << order);
+        base += 1L << order;
+    }
+}
+
+/**
+ * Agrega un bloque libre al inicio de la lista de su orden en O(1).
+ * @param block_index El indice del bloque.
+ * */
+void buddy_push(int block_index) {
+    MemoryBlock *block = block_at(memory->blocks, block_index);
+    int order = buddy_order(block->size);
+    int head = memory->buddy_lists[order];
+
+    block->free_previous = NO_BLOCK;
+    block->free_next = head;
+    if (head != NO_BLOCK) {
+        block_at(memory->blocks, head)->free_previous = block_index;
+    }
+    memory->buddy_lists[order] = block_index;
+    memory->buddy_orders |= 1UL << order;
+}
+
+/**
+ * Remueve un bloque libre de la lista de su orden en O(1).
+ * @param block_index El indice del bloque.
+ * @return true si el bloque estaba en la lista, false en caso contrario.
+ * */
+bool buddy_remove(int block_index) {
+    MemoryBlock *block = block_at(memory->blocks, block_index);
+    int order = buddy_order(block->size);
+
+    // El bloque no esta en ninguna lista.
+    if (block->free_previous == NO_BLOCK && memory->buddy_lists[order] != block_index) {
+        return false;
+    }
+
+    if (block->free_previous == NO_BLOCK) {
+        memory->buddy_lists[order] = block->free_next;
+    } else {
+        block_at(memory->blocks, block->free_previous)->free_next = block->free_next;
+    }
+    if (block->free_next != NO_BLOCK) {
+        block_at(memory->blocks, block->free_next)->free_previous = block->free_previous;
+    }
+    block->free_previous = NO_BLOCK;
+    block->free_next = NO_BLOCK;
+
+    if (memory->buddy_lists[order] == NO_BLOCK) {
+        memory->buddy_orders &= ~(1UL << order);
+    }
+    return true;
+}
+
+/**
+ * Asigna un proceso al menor bloque buddy disponible. Si el bloque es mas grande
+ * que el orden requerido, se divide a la mitad hasta llegar a ese orden.
+ * @param process El proceso a asignar.
+ * @return El indice del bloque asignado, NO_BLOCK si no hay espacio.
+ * */
+int buddy_alloc(Process *process) {
+    int order = buddy_order(process->size);
+    if (order >= BUDDY_ORDERS) {
+        return NO_BLOCK;
+    }
+
+    // El menor orden con bloques libres que alcance para el proceso.
+    unsigned long candidates = memory->buddy_orders & (~0UL << order);
+    if (candidates == 0) {
+        return NO_BLOCK;
+    }
+    int current = __builtin_ctzl(candidates);
+    int block_index = memory->buddy_lists[current];
+    unindex_free_block(block_index);
+
+    // La mitad superior de cada division queda libre en la lista del orden inferior.
+    while (current > order) {
+        current--;
+        MemoryBlock *block = block_at(memory->blocks, block_index);
+        block->size = 1L << current;
+        make_memory_block(block_index, block->base + block->size, 1L << current);
+    }
+
+    MemoryBlock *block = block_at(memory->blocks, block_index);
+    block->process = process;
+    block->process->state = READY;
+    memory->allocated_blocks++;
+    hash_put(memory->owners, process->pid, block_index);
+    return block_index;
+}
+
+/**
+ * Une un bloque recien liberado con su buddy mientras este tambien este libre
+ * y tenga el mismo orden. Cada union cuesta O(1), por lo que liberar cuesta O(log N).
+ * @param block_index El indice del bloque liberado.
+ * @return El indice del bloque resultante.
+ * */
+int buddy_merge(int block_index) {
+    BlockTable *blocks = memory->blocks;
+
+    while (true) {
+        MemoryBlock *block = block_at(blocks, block_index);
+        long buddy_base = block->base ^ block->size;
+        // El buddy siempre es el vecino inmediato en la tabla.
+        int buddy = buddy_base < block->base ? block->previous : block->next;
+        if (buddy == NO_BLOCK) {
+            break;
+        }
+
+        MemoryBlock *other = block_at(blocks, buddy);
+        if (other->process != NULL || other->base != buddy_base || other->size != block->size) {
+            break;
+        }
+
+        unindex_free_block(buddy);
+        if (buddy_base < block->base) {
+            other->size *= 2;
+            table_remove(blocks, block_index);
+            block_index = buddy;
+        } else {
+            block->size *= 2;
+            table_remove(blocks, buddy);
+        }
+    }
+
+    index_free_block(block_index);
+    return block_index;
+}
+
+/**
+ * Obtiene el tamaño del mayor bloque libre en O(1): todos los bloques de un
+ * orden miden lo mismo, asi que basta con el mayor orden con bloques libres.
+ * @return El tamaño del bloque, 0 si no hay bloques libres.
+ * */
+long buddy_largest() {
+    if (memory->buddy_orders == 0) {
+        return 0;
+    }
+    return 1L << (63 - __builtin_clzl(memory->buddy_orders));
+}
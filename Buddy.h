@@ -0,0 +1,17 @@
+//
+// Created by yaelao on 6/8/23.
+//
+
+#ifndef SHELL_BUDDY_H
+#define SHELL_BUDDY_H
+
+#include "Memory.h"
+
+int buddy_order(long size);
+void buddy_layout();
+void buddy_push(int block_index);
+bool buddy_remove(int block_index);
+int buddy_alloc(Process *process);
+int buddy_merge(int block_index);
+long buddy_largest();
+#endif //SHELL_BUDDY_H
@@ -0,0 +1,125 @@
+//
+// Created by yaelao on 6/21/23.
+//
+
+#include "Cfs.h"
+
+// El peso de cada valor nice, de -20 a 19; cada nivel pesa cerca de 1.25 veces el siguiente.
+static const int nice_weights[MAX_NICE - MIN_NICE + 1] = {
+        88761, 71755, 56483, 46273, 36291,
+        29154, 23254, 18705, 14949, 11916,
+        9548, 7620, 6100, 4904, 3906,
+        3121, 2501, 1991, 1586, 1277,
+        1024, 820, 655, 526, 423,
+        335, 272, 215, 172, 137,
+        110, 87, 70, 56, 45,
+        36, 29, 23, 18, 15,
+};
+
+/**
+ * Esta funcion obtiene el peso de un valor nice.
+ * @param nice El valor nice, entre MIN_NICE y MAX_NICE.
+ * @return El peso; un proceso recibe CPU en proporcion a su peso.
+ * */
+int nice_weight(int nice) {
+    return nice_weights[nice - MIN_NICE];
+}
+
+/**
+ * Crea el arbol de trabajos listos.
+ * */
+static void *create_cfs(Scheduler *scheduler) {
+    Cfs *cfs = (Cfs *) calloc(1, sizeof(Cfs));
+    cfs->tree = create_tree();
+    return cfs;
+}
+
+/**
+ * Libera el arbol de trabajos listos.
+ * */
+static void destroy_cfs(void *ready) {
+    Cfs *cfs = (Cfs *) ready;
+    clear_tree(cfs->tree);
+    free(cfs);
+}
+
+/**
+ * Obtiene el tiempo virtual que avanza un proceso en un tiempo real: un proceso
+ * con mas peso avanza mas despacio.
+ * */
+static inline long virtual_time(Process *process, long elapsed) {
+    return elapsed * 1000000L * NICE_0_WEIGHT / nice_weight(process->nice);
+}
+
+/**
+ * Agrega un trabajo al arbol. Un trabajo que salio del CPU avanza su tiempo
+ * virtual por lo que se ejecuto; uno que llega empieza al menos en el menor
+ * tiempo virtual, para que no acapare el CPU por haber llegado tarde.
+ * */
+static void cfs_enqueue(Scheduler *scheduler, Job *job, enum ReadyReason reason) {
+    Cfs *cfs = (Cfs *) scheduler->ready;
+    Process *process = job->process;
+    if (reason == ARRIVED) {
+        if (process->vruntime < cfs->min_vruntime) {
+            process->vruntime = cfs->min_vruntime;
+        }
+    } else {
+        process->vruntime += virtual_time(process, scheduler->now - job->dispatched);
+    }
+    tree_insert(cfs->tree, process->vruntime, job);
+    cfs->ready_weight += nice_weight(process->nice);
+}
+
+/**
+ * Remueve el trabajo con el menor tiempo virtual, que esta en cache.
+ * */
+static Job *cfs_pick(Scheduler *scheduler) {
+    Cfs *cfs = (Cfs *) scheduler->ready;
+    TreeNode *first = tree_first(cfs->tree);
+    if (first == NULL) {
+        return NULL;
+    }
+    Job *job = (Job *) first->data;
+    if (first->key > cfs->min_vruntime) {
+        cfs->min_vruntime = first->key;
+    }
+    cfs->ready_weight -= nice_weight(job->process->nice);
+    tree_remove(cfs->tree, first);
+    return job;
+}
+
+/**
+ * Obtiene el trabajo con el menor tiempo virtual.
+ * */
+static Job *cfs_peek(Scheduler *scheduler) {
+    TreeNode *first = tree_first(((Cfs *) scheduler->ready)->tree);
+    return first == NULL ? NULL : (Job *) first->data;
+}
+
+/**
+ * Reparte el periodo entre los trabajos listos en proporcion a su peso. El
+ * periodo crece si hay tantos trabajos que el turno seria menor al minimo.
+ * */
+static long weighted_slice(Scheduler *scheduler, Job *job) {
+    Cfs *cfs = (Cfs *) scheduler->ready;
+    long weight = nice_weight(job->process->nice), total_weight = cfs->ready_weight + weight;
+    long runnable = cfs->tree->size + 1;
+    long period = runnable * CFS_MIN_GRANULARITY > CFS_LATENCY ? runnable * CFS_MIN_GRANULARITY : CFS_LATENCY;
+    long slice = period * weight / total_weight;
+    return slice > CFS_MIN_GRANULARITY ? slice : CFS_MIN_GRANULARITY;
+}
+
+/**
+ * Un trabajo que llega saca al que esta en el CPU si este ya le lleva mas de
+ * CFS_WAKEUP_GRANULARITY de tiempo virtual.
+ * */
+static bool behind_in_vruntime(Scheduler *scheduler, Job *running, Job *arrived) {
+    Process *process = running->process;
+    long vruntime = process->vruntime + virtual_time(process, scheduler->now - running->dispatched);
+    return vruntime - arrived->process->vruntime > CFS_WAKEUP_GRANULARITY;
+}
+
+SchedulerPolicy cfs_policy = {
+        .name = "cfs", .create = create_cfs, .destroy = destroy_cfs, .enqueue = cfs_enqueue,
+        .pick = cfs_pick, .peek = cfs_peek, .slice = weighted_slice, .preempts = behind_in_vruntime
+};
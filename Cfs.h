@@ -0,0 +1,40 @@
+//
+// Created by yaelao on 6/21/23.
+//
+
+#ifndef SHELL_CFS_H
+#define SHELL_CFS_H
+
+#include "Scheduler.h"
+#include "Tree.h"
+
+// El peso de un proceso con nice 0.
+#define NICE_0_WEIGHT 1024
+
+// El tiempo en que cada trabajo listo deberia pasar por el CPU, en ms.
+#define CFS_LATENCY 20
+
+// El menor tiempo que un trabajo esta en el CPU por turno, en ms.
+#define CFS_MIN_GRANULARITY 2
+
+// La ventaja en tiempo virtual que necesita un trabajo que llega para sacar al que
+// esta en el CPU, en ns.
+#define CFS_WAKEUP_GRANULARITY 1000000L
+
+/**
+ * Estructura que representa la cola de listos del planificador justo: un arbol
+ * rojo-negro de trabajos ordenado por tiempo virtual, con el de menor tiempo en cache.
+ * @param tree Los trabajos listos; la llave es el tiempo virtual de su proceso.
+ * @param ready_weight La suma de los pesos de los trabajos del arbol.
+ * @param min_vruntime El menor tiempo virtual visto; nunca disminuye.
+ * */
+typedef struct {
+    Tree *tree;
+    long ready_weight;
+    long min_vruntime;
+} Cfs;
+
+extern SchedulerPolicy cfs_policy;
+
+int nice_weight(int nice);
+#endif //SHELL_CFS_H
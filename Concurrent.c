@@ -0,0 +1,315 @@
+//
+// Created by yaelao on 6/18/23.
+//
+
+#include <math.h>
+#include "Concurrent.h"
+
+/**
+ * Obtiene la clase del cache de un tamaño. La clase 0 guarda los tamaños hasta
+ * tcache_limit, y cada clase siguiente la mitad; la ultima guarda todos los demas.
+ * @return La clase, NO_BIN si el tamaño es muy grande para el cache.
+ * */
+static int tcache_bin(Worker *worker, long size) {
+    if (size > worker->tcache_limit) {
+        return NO_BIN;
+    }
+    int bin = 0;
+    while (bin < TCACHE_BINS - 1 && size <= worker->tcache_limit >> (bin + 1)) {
+        bin++;
+    }
+    return bin;
+}
+
+/**
+ * Toma el candado de una arena, contando si estaba ocupado y cuanto se espero.
+ * */
+static void lock_shard(Worker *worker, Shard *shard) {
+    worker->acquisitions++;
+    if (pthread_mutex_trylock(&shard->lock) == 0) {
+        return;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_mutex_lock(&shard->lock);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    worker->contended++;
+    worker->waited += (double) (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/**
+ * Asigna memoria a un proceso en una arena.
+ * @return true si se asigno la memoria, false si no hay espacio.
+ * */
+static bool shard_allocate(Worker *worker, int index, Process *process) {
+    Shard *shard = &worker->shards[index];
+    lock_shard(worker, shard);
+    memory = shard->memory;
+    bool allocated = allocate_memory(process, worker->fit) >= 0;
+    atomic_store_explicit(&shard->free_units, memory->remaining_size, memory_order_relaxed);
+    pthread_mutex_unlock(&shard->lock);
+    return allocated;
+}
+
+/**
+ * Libera en su arena la memoria de una asignacion.
+ * */
+static void shard_free(Worker *worker, Handle *handle) {
+    Shard *shard = &worker->shards[handle->shard];
+    lock_shard(worker, shard);
+    memory = shard->memory;
+    free_memory(handle->process->pid);
+    atomic_store_explicit(&shard->free_units, memory->remaining_size, memory_order_relaxed);
+    pthread_mutex_unlock(&shard->lock);
+    free(handle->process);
+}
+
+/**
+ * Agrega una asignacion a las que tiene un hilo.
+ * */
+static void track_handle(Worker *worker, Handle handle) {
+    if (worker->num_live == worker->live_capacity) {
+        worker->live_capacity *= 2;
+        worker->live = (Handle *) realloc(worker->live, worker->live_capacity * sizeof(Handle));
+    }
+    worker->live[worker->num_live++] = handle;
+}
+
+/**
+ * Asigna memoria para un hilo. Primero se busca un bloque del tamaño en el cache
+ * del hilo, sin candado; despues en la arena del hilo, y si no hay espacio, en las
+ * demas arenas que segun su memoria libre, leida sin candado, podrian tenerlo.
+ * */
+static void worker_alloc(Worker *worker, long size) {
+    worker->allocations++;
+
+    // Los tamaños del cache se redondean a su clase para que cualquier bloque de la clase sirva.
+    int bin = tcache_bin(worker, size);
+    if (bin != NO_BIN) {
+        size = worker->tcache_limit >> bin;
+        TcacheBin *tcache = &worker->tcache[bin];
+        if (tcache->count > 0) {
+            worker->tcache_hits++;
+            track_handle(worker, tcache->entries[--tcache->count]);
+            return;
+        }
+    }
+
+    Handle handle = {(Process *) malloc(sizeof(Process)), worker->id % worker->num_shards};
+    *handle.process = (Process) {.pid = worker->next_pid, .state = NEW, .size = size};
+    worker->next_pid += worker->num_threads;
+
+    if (!shard_allocate(worker, handle.shard, handle.process)) {
+        int home = handle.shard;
+        handle.shard = NO_BLOCK;
+        for (int i = 1; i < worker->num_shards && handle.shard == NO_BLOCK; i++) {
+            int other = (home + i) % worker->num_shards;
+            if (atomic_load_explicit(&worker->shards[other].free_units, memory_order_relaxed) >= size
+                && shard_allocate(worker, other, handle.process)) {
+                handle.shard = other;
+                worker->fallbacks++;
+            }
+        }
+        if (handle.shard == NO_BLOCK) {
+            worker->failures++;
+            free(handle.process);
+            return;
+        }
+    }
+
+    track_handle(worker, handle);
+}
+
+/**
+ * Libera una asignacion de un hilo. Si su clase del cache tiene lugar, el bloque
+ * se guarda en el cache sin regresarlo a la arena.
+ * */
+static void worker_free(Worker *worker, int index) {
+    Handle handle = worker->live[index];
+    worker->live[index] = worker->live[--worker->num_live];
+
+    int bin = tcache_bin(worker, handle.process->size);
+    if (bin != NO_BIN && worker->tcache[bin].count < TCACHE_COUNT) {
+        worker->tcache[bin].entries[worker->tcache[bin].count++] = handle;
+        return;
+    }
+    shard_free(worker, &handle);
+}
+
+/**
+ * Hace las operaciones de un hilo: asigna un poco mas de lo que libera, como
+ * churn, con tamaños de distribucion exponencial. Al terminar regresa a las
+ * arenas todo lo que el hilo tiene, fuera del tiempo medido.
+ * */
+static void *run_worker(void *data) {
+    Worker *worker = (Worker *) data;
+    pthread_barrier_wait(worker->start);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    long shard_size = worker->shards[worker->id % worker->num_shards].memory->total_size;
+    for (long i = 0; i < worker->events; i++) {
+        if (worker->num_live == 0 || next_uniform(&worker->random) < 0.55) {
+            double size = -(double) worker->mean_size * log(1.0 - next_uniform(&worker->random));
+            worker_alloc(worker, size < 1.0 ? 1 : size > (double) shard_size ? shard_size : (long) size);
+        } else {
+            worker_free(worker, (int) (next_random(&worker->random) % (uint64_t) worker->num_live));
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    worker->seconds = (double) (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    for (int bin = 0; bin < TCACHE_BINS; bin++) {
+        while (worker->tcache[bin].count > 0) {
+            shard_free(worker, &worker->tcache[bin].entries[--worker->tcache[bin].count]);
+        }
+    }
+    while (worker->num_live > 0) {
+        shard_free(worker, &worker->live[--worker->num_live]);
+    }
+    free(worker->live);
+    return NULL;
+}
+
+/**
+ * Libera las arenas.
+ * */
+static void destroy_shards(Shard *shards, int num_shards) {
+    Memory *current = memory;
+    for (int i = 0; i < num_shards; i++) {
+        memory = shards[i].memory;
+        release_memory();
+        pthread_mutex_destroy(&shards[i].lock);
+    }
+    memory = current;
+    free(shards);
+}
+
+/**
+ * Crea las arenas dividiendo la memoria actual en partes iguales.
+ * @return Las arenas, NULL si el algoritmo no se puede usar con el modelo de la memoria.
+ * */
+static Shard *create_shards(char *fit, int num_shards) {
+    Memory *current = memory;
+    Shard *shards = (Shard *) malloc(num_shards * sizeof(Shard));
+    bool valid = true;
+
+    for (int i = 0; i < num_shards; i++) {
+        memory = NULL;
+        init_memory(current->model, current->total_size / num_shards);
+        valid = select_fit(fit) && valid;
+        shards[i].memory = memory;
+        pthread_mutex_init(&shards[i].lock, NULL);
+        atomic_init(&shards[i].free_units, memory->remaining_size);
+    }
+    memory = current;
+
+    if (!valid) {
+        destroy_shards(shards, num_shards);
+        return NULL;
+    }
+    return shards;
+}
+
+/**
+ * Ejecuta una ronda con un numero de hilos y arenas, e imprime su renglon.
+ * @return Las operaciones por segundo, -1 si el algoritmo no se puede usar.
+ * */
+static double run_round(char *fit, long events, int num_threads, double base_rate) {
+    Shard *shards = create_shards(fit, num_threads);
+    if (shards == NULL) {
+        return -1;
+    }
+    // El encabezado se imprime hasta saber que el algoritmo se puede usar.
+    if (num_threads == 1) {
+        printf("%-8s %-12s %-8s %-9s %-11s %-10s %-10s %s\n", "Threads", "Ops/s", "Speedup",
+               "Failed%", "Tcache%", "Remote%", "Contended%", "Wait ms");
+    }
+
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, num_threads);
+    Worker *workers = (Worker *) calloc(num_threads, sizeof(Worker));
+    pthread_t *threads = (pthread_t *) malloc(num_threads * sizeof(pthread_t));
+    long shard_size = shards[0].memory->total_size;
+    long mean_size = shard_size / 256 > 0 ? shard_size / 256 : 1, tcache_limit = 1;
+    while (tcache_limit < mean_size) {
+        tcache_limit *= 2;
+    }
+
+    for (int i = 0; i < num_threads; i++) {
+        Worker *worker = &workers[i];
+        worker->id = i;
+        worker->events = events / num_threads + (i < events % num_threads ? 1 : 0);
+        // El generador no puede iniciar en 0.
+        worker->random = (uint64_t) (i + 1) * 0x9E3779B97F4A7C15ULL + 1;
+        worker->fit = fit;
+        worker->mean_size = mean_size;
+        worker->tcache_limit = tcache_limit;
+        worker->num_threads = num_threads;
+        worker->next_pid = i;
+        worker->shards = shards;
+        worker->num_shards = num_threads;
+        worker->start = &start;
+        worker->live_capacity = 64;
+        worker->live = (Handle *) malloc(worker->live_capacity * sizeof(Handle));
+        pthread_create(&threads[i], NULL, run_worker, worker);
+    }
+
+    Worker total = {0};
+    for (int i = 0; i < num_threads; i++) {
+        pthread_join(threads[i], NULL);
+        total.allocations += workers[i].allocations;
+        total.failures += workers[i].failures;
+        total.tcache_hits += workers[i].tcache_hits;
+        total.fallbacks += workers[i].fallbacks;
+        total.acquisitions += workers[i].acquisitions;
+        total.contended += workers[i].contended;
+        total.waited += workers[i].waited;
+        total.seconds = workers[i].seconds > total.seconds ? workers[i].seconds : total.seconds;
+    }
+
+    double rate = total.seconds > 0 ? (double) events / total.seconds : 0.0;
+    double allocations = total.allocations > 0 ? (double) total.allocations : 1.0;
+    printf("%-8d %-12.0f %-8.2f %-9.2f %-11.2f %-10.2f %-10.2f %.3f\n", num_threads, rate,
+           base_rate > 0 ? rate / base_rate : 1.0,
+           100.0 * (double) total.failures / allocations,
+           100.0 * (double) total.tcache_hits / allocations,
+           100.0 * (double) total.fallbacks / allocations,
+           total.acquisitions > 0 ? 100.0 * (double) total.contended / (double) total.acquisitions : 0.0,
+           total.waited * 1e3);
+
+    pthread_barrier_destroy(&start);
+    free(workers);
+    free(threads);
+    destroy_shards(shards, num_threads);
+    return rate;
+}
+
+/**
+ * Esta funcion simula un asignador concurrente: varios hilos asignan y liberan
+ * memoria al azar, cada uno en su propia arena (una parte de la memoria actual
+ * con su propio candado) y con un cache de bloques liberados por hilo. Si su
+ * arena no tiene espacio, el hilo usa otra. Las rondas van de 1 hilo al numero
+ * indicado, duplicando, y cada una imprime las operaciones por segundo y la
+ * contencion de los candados. La memoria actual no se modifica.
+ * @param fit El algoritmo de asignacion de memoria.
+ * @param events El numero total de operaciones de cada ronda.
+ * @param max_threads El mayor numero de hilos.
+ * @return true si se ejecutaron las rondas, false si el algoritmo no se puede usar.
+ * */
+bool run_concurrent(char *fit, long events, int max_threads) {
+    double base_rate = 0;
+    for (int threads = 1;; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+        double rate = run_round(fit, events, threads, base_rate);
+        if (rate < 0) {
+            return false;
+        }
+        if (threads == 1) {
+            base_rate = rate;
+        }
+        if (threads >= max_threads) {
+            return true;
+        }
+    }
+}
@@ -0,0 +1,109 @@
+//
+// Created by yaelao on 6/18/23.
+//
+
+#ifndef SHELL_CONCURRENT_H
+#define SHELL_CONCURRENT_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+#include "Memory.h"
+#include "Replay.h"
+
+// Numero de clases de tamaño del cache de cada hilo.
+#define TCACHE_BINS 8
+// Numero de bloques que guarda cada clase del cache, como el tcache de glibc.
+#define TCACHE_COUNT 7
+#define NO_BIN (-1)
+
+/**
+ * Estructura que representa una asignacion hecha por un hilo.
+ * @param process El proceso que tiene la memoria.
+ * @param shard La arena donde esta la memoria.
+ * */
+typedef struct {
+    Process *process;
+    int shard;
+} Handle;
+
+/**
+ * Estructura que representa una arena: una memoria simulada independiente,
+ * protegida por su propio candado.
+ * @param lock El candado de la arena.
+ * @param memory La memoria de la arena.
+ * @param free_units La memoria libre despues de la ultima operacion; se lee sin
+ * candado para descartar las arenas llenas antes de bloquearlas.
+ * */
+typedef struct {
+    pthread_mutex_t lock;
+    Memory *memory;
+    _Atomic long free_units;
+} Shard;
+
+/**
+ * Estructura que representa una clase del cache de un hilo: bloques que el hilo
+ * libero pero que siguen asignados en su arena, para reusarlos sin candado.
+ * @param entries Los bloques guardados.
+ * @param count El numero de bloques guardados.
+ * */
+typedef struct {
+    Handle entries[TCACHE_COUNT];
+    int count;
+} TcacheBin;
+
+/**
+ * Estructura que representa un hilo que asigna y libera memoria al azar.
+ * @param id El numero del hilo; su arena es id % num_shards.
+ * @param events El numero de operaciones que hace el hilo.
+ * @param random El estado del generador de numeros aleatorios.
+ * @param fit El algoritmo de asignacion de memoria.
+ * @param mean_size El tamaño medio de las asignaciones.
+ * @param tcache_limit El mayor tamaño que se guarda en el cache; es una potencia de dos.
+ * @param num_threads El numero de hilos, para que los pid no se repitan.
+ * @param next_pid El pid de la siguiente asignacion.
+ * @param shards Las arenas.
+ * @param num_shards El numero de arenas.
+ * @param start La barrera donde los hilos esperan para iniciar juntos.
+ * @param live Las asignaciones que el hilo tiene.
+ * @param num_live El numero de asignaciones que el hilo tiene.
+ * @param live_capacity El numero de asignaciones que caben en live.
+ * @param tcache El cache del hilo, por clase de tamaño.
+ * @param allocations El numero de asignaciones intentadas.
+ * @param failures El numero de asignaciones que no encontraron espacio en ninguna arena.
+ * @param tcache_hits El numero de asignaciones que se tomaron del cache.
+ * @param fallbacks El numero de asignaciones que se hicieron en otra arena.
+ * @param acquisitions El numero de veces que se tomo un candado.
+ * @param contended El numero de veces que el candado estaba ocupado.
+ * @param waited El tiempo esperando candados ocupados, en segundos.
+ * @param seconds El tiempo de las operaciones del hilo.
+ * */
+typedef struct {
+    int id;
+    long events;
+    uint64_t random;
+    char *fit;
+    long mean_size;
+    long tcache_limit;
+    int num_threads;
+    int next_pid;
+    Shard *shards;
+    int num_shards;
+    pthread_barrier_t *start;
+    Handle *live;
+    int num_live;
+    int live_capacity;
+    TcacheBin tcache[TCACHE_BINS];
+    long allocations;
+    long failures;
+    long tcache_hits;
+    long fallbacks;
+    long acquisitions;
+    long contended;
+    double waited;
+    double seconds;
+} Worker;
+
+bool run_concurrent(char *fit, long events, int max_threads);
+#endif //SHELL_CONCURRENT_H
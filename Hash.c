@@ -0,0 +1,139 @@
+//
+// Created by yaelao on 6/12/23.
+//
+
+#include "Hash.h"
+
+/**
+ * Crea una tabla hash vacia.
+ * @param capacity El numero inicial de entradas; se redondea a una potencia de dos.
+ * @return La tabla creada.
+ * */
+HashMap *create_hash(int capacity) {
+    HashMap *map = (HashMap *) malloc(sizeof(HashMap));
+    map->capacity = 8;
+    while (map->capacity < capacity) {
+        map->capacity *= 2;
+    }
+    map->entries = (HashEntry *) calloc(map->capacity, sizeof(HashEntry));
+    map->size = 0;
+    return map;
+}
+
+/**
+ * Libera la memoria reservada para la tabla.
+ * */
+void clear_hash(HashMap *map) {
+    free(map->entries);
+    free(map);
+}
+
+/**
+ * Remueve todas las entradas de la tabla sin cambiar su capacidad.
+ * */
+void hash_reset(HashMap *map) {
+    for (int i = 0; i < map->capacity; i++) {
+        map->entries[i].used = false;
+    }
+    map->size = 0;
+}
+
+/**
+ * Obtiene la posicion inicial de una llave. Se multiplica por una constante
+ * impar para que pids consecutivos no queden en posiciones consecutivas.
+ * */
+static int home_of(HashMap *map, int key) {
+    return (int) (((unsigned int) key * 2654435769U) & (unsigned int) (map->capacity - 1));
+}
+
+/**
+ * Busca la posicion de una llave, o la posicion vacia donde se agregaria.
+ * */
+static int find_position(HashMap *map, int key) {
+    int position = home_of(map, key);
+    while (map->entries[position].used && map->entries[position].key != key) {
+        position = (position + 1) & (map->capacity - 1);
+    }
+    return position;
+}
+
+/**
+ * Duplica la capacidad de la tabla y vuelve a acomodar las entradas.
+ * */
+static void grow(HashMap *map) {
+    HashEntry *entries = map->entries;
+    int capacity = map->capacity;
+
+    map->capacity *= 2;
+    map->entries = (HashEntry *) calloc(map->capacity, sizeof(HashEntry));
+    for (int i = 0; i < capacity; i++) {
+        if (entries[i].used) {
+            map->entries[find_position(map, entries[i].key)] = entries[i];
+        }
+    }
+    free(entries);
+}
+
+/**
+ * Agrega una llave o reemplaza su valor en O(1) promedio.
+ * La tabla crece antes de pasar de la mitad de su capacidad.
+ * @param map La tabla.
+ * @param key La llave.
+ * @param value El valor.
+ * */
+void hash_put(HashMap *map, int key, int value) {
+    if (2 * (map->size + 1) > map->capacity) {
+        grow(map);
+    }
+
+    HashEntry *entry = &map->entries[find_position(map, key)];
+    if (!entry->used) {
+        entry->used = true;
+        entry->key = key;
+        map->size++;
+    }
+    entry->value = value;
+}
+
+/**
+ * Obtiene el valor de una llave en O(1) promedio.
+ * @param map La tabla.
+ * @param key La llave.
+ * @return El valor, NOT_FOUND si la llave no esta en la tabla.
+ * */
+int hash_get(HashMap *map, int key) {
+    HashEntry *entry = &map->entries[find_position(map, key)];
+    return entry->used ? entry->value : NOT_FOUND;
+}
+
+/**
+ * Remueve una llave en O(1) promedio. Las entradas siguientes se recorren hacia
+ * atras para no dejar huecos en sus secuencias de sondeo, sin usar marcas de borrado.
+ * @param map La tabla.
+ * @param key La llave.
+ * @return true si se removio la llave, false si no estaba en la tabla.
+ * */
+bool hash_remove(HashMap *map, int key) {
+    int mask = map->capacity - 1;
+    int hole = find_position(map, key);
+    if (!map->entries[hole].used) {
+        return false;
+    }
+
+    int position = hole;
+    while (true) {
+        position = (position + 1) & mask;
+        if (!map->entries[position].used) {
+            break;
+        }
+        // La entrada se puede mover al hueco si su posicion inicial no esta entre ambos.
+        int home = home_of(map, map->entries[position].key);
+        if (((position - home) & mask) >= ((position - hole) & mask)) {
+            map->entries[hole] = map->entries[position];
+            hole = position;
+        }
+    }
+    map->entries[hole].used = false;
+    map->size--;
+    return true;
+}
@@ -0,0 +1,45 @@
+//
+// Created by yaelao on 6/12/23.
+//
+
+#ifndef SHELL_HASH_H
+#define SHELL_HASH_H
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Valor que indica que una llave no esta en la tabla.
+#define NOT_FOUND (-1)
+
+/**
+ * Estructura que representa una entrada de la tabla hash.
+ * @param key La llave de la entrada.
+ * @param value El valor asociado a la llave.
+ * @param used true si la entrada esta ocupada.
+ * */
+typedef struct {
+    int key;
+    int value;
+    bool used;
+} HashEntry;
+
+/**
+ * Estructura que representa una tabla hash de enteros con direccionamiento
+ * abierto y sondeo lineal.
+ * @param entries Las entradas de la tabla.
+ * @param capacity El numero de entradas; siempre es una potencia de dos.
+ * @param size El numero de entradas ocupadas.
+ * */
+typedef struct {
+    HashEntry *entries;
+    int capacity;
+    int size;
+} HashMap;
+
+HashMap *create_hash(int capacity);
+void clear_hash(HashMap *map);
+void hash_reset(HashMap *map);
+void hash_put(HashMap *map, int key, int value);
+int hash_get(HashMap *map, int key);
+bool hash_remove(HashMap *map, int key);
+#endif //SHELL_HASH_H
@@ -0,0 +1,103 @@
+//
+// Created by yaelao on 6/21/23.
+//
+
+#include "Heap.h"
+
+/**
+ * Crea un heap vacio.
+ * @param capacity El numero inicial de elementos; el arreglo crece al llenarse.
+ * @return El heap creado.
+ * */
+Heap *create_heap(int capacity) {
+    Heap *heap = (Heap *) malloc(sizeof(Heap));
+    heap->capacity = capacity > 8 ? capacity : 8;
+    heap->items = (HeapItem *) malloc(heap->capacity * sizeof(HeapItem));
+    heap->size = 0;
+    return heap;
+}
+
+/**
+ * Libera la memoria reservada para el heap. Los datos de los elementos no se liberan.
+ * */
+void clear_heap(Heap *heap) {
+    free(heap->items);
+    free(heap);
+}
+
+/**
+ * Indica si un elemento sale antes que otro.
+ * */
+static inline bool goes_before(HeapItem *item1, HeapItem *item2) {
+    return item1->key < item2->key || (item1->key == item2->key && item1->order < item2->order);
+}
+
+/**
+ * Esta funcion agrega un elemento al heap.
+ * @param heap El heap.
+ * @param item El elemento, se copia.
+ * */
+void heap_push(Heap *heap, HeapItem item) {
+    if (heap->size == heap->capacity) {
+        heap->capacity *= 2;
+        heap->items = (HeapItem *) realloc(heap->items, heap->capacity * sizeof(HeapItem));
+    }
+
+    // El elemento sube desde el final mientras sea menor que su padre.
+    int child = heap->size++;
+    while (child > 0) {
+        int parent = (child - 1) / 2;
+        if (!goes_before(&item, &heap->items[parent])) {
+            break;
+        }
+        heap->items[child] = heap->items[parent];
+        child = parent;
+    }
+    heap->items[child] = item;
+}
+
+/**
+ * Esta funcion remueve el menor elemento del heap.
+ * @param heap El heap, no debe estar vacio.
+ * @return El elemento removido.
+ * */
+HeapItem heap_pop(Heap *heap) {
+    HeapItem top = heap->items[0];
+    HeapItem last = heap->items[--heap->size];
+
+    // El ultimo elemento baja desde la raiz mientras alguno de sus hijos sea menor.
+    int parent = 0;
+    while (true) {
+        int child = 2 * parent + 1;
+        if (child >= heap->size) {
+            break;
+        }
+        if (child + 1 < heap->size && goes_before(&heap->items[child + 1], &heap->items[child])) {
+            child++;
+        }
+        if (!goes_before(&heap->items[child], &last)) {
+            break;
+        }
+        heap->items[parent] = heap->items[child];
+        parent = child;
+    }
+    if (heap->size > 0) {
+        heap->items[parent] = last;
+    }
+    return top;
+}
+
+/**
+ * Obtiene el menor elemento del heap sin removerlo.
+ * @return El elemento, NULL si el heap esta vacio.
+ * */
+HeapItem *heap_top(Heap *heap) {
+    return heap->size > 0 ? &heap->items[0] : NULL;
+}
+
+/**
+ * Indica si el heap esta vacio.
+ * */
+bool is_heap_empty(Heap *heap) {
+    return heap->size == 0;
+}
@@ -0,0 +1,43 @@
+//
+// Created by yaelao on 6/21/23.
+//
+
+#ifndef SHELL_HEAP_H
+#define SHELL_HEAP_H
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * Estructura que representa un elemento del heap.
+ * @param key La llave; sale primero el elemento con la menor llave.
+ * @param order Desempata elementos con la misma llave; sale primero el menor.
+ * @param tag Un valor libre para quien usa el heap, por ejemplo el tipo de evento.
+ * @param data El dato del elemento.
+ * */
+typedef struct {
+    long key;
+    long order;
+    int tag;
+    void *data;
+} HeapItem;
+
+/**
+ * Estructura que representa un heap binario de minimos sobre un arreglo.
+ * @param items Los elementos; el menor esta en la posicion 0.
+ * @param size El numero de elementos.
+ * @param capacity El numero de elementos que caben en items.
+ * */
+typedef struct {
+    HeapItem *items;
+    int size;
+    int capacity;
+} Heap;
+
+Heap *create_heap(int capacity);
+void clear_heap(Heap *heap);
+void heap_push(Heap *heap, HeapItem item);
+HeapItem heap_pop(Heap *heap);
+HeapItem *heap_top(Heap *heap);
+bool is_heap_empty(Heap *heap);
+#endif //SHELL_HEAP_H
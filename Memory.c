@@ -3,24 +3,381 @@
 //
 
 #include "Memory.h"
+#include "Swap.h"
+#include "Buddy.h"
+#include "Tlsf.h"
+
+_Thread_local Memory *memory;
+
+/**
+ * Obtiene el indice del bloque guardado en un nodo del indice de bloques libres.
+ * */
+static int block_of(TreeNode *node) {
+    return (int) (intptr_t) node->data;
+}
+
+/**
+ * Suma o resta un bloque libre de las metricas de fragmentacion.
+ * Todo bloque libre pasa por el indice de bloques libres, asi que las metricas
+ * se mantienen al dia sin recorrer la tabla. Por la misma razon todo cambio de
+ * los bloques pasa por aqui y cambia la generacion de la memoria.
+ * @param size El tamaño del bloque.
+ * @param sign 1 si el bloque entra al indice, -1 si sale.
+ * */
+static void count_free_block(long size, int sign) {
+    memory->remaining_size += sign * size;
+    memory->free_count += sign;
+    memory->free_classes[63 - __builtin_clzl((unsigned long) size)] += sign;
+    memory->generation++;
+}
+
+/**
+ * Agrega un bloque libre al indice de bloques libres de la forma de
+ * administracion actual: el arbol por tamaño, la lista de su orden buddy
+ * o su lista segregada TLSF.
+ * @param block_index El indice del bloque.
+ * */
+void index_free_block(int block_index) {
+    MemoryBlock *block = block_at(memory->blocks, block_index);
+    count_free_block(block->size, 1);
+
+    if (memory->mode == BUDDY_MODE) {
+        buddy_push(block_index);
+    } else if (memory->mode == TLSF_MODE) {
+        tlsf_insert(block_index);
+    } else {
+        block->free_node = tree_insert(memory->free_blocks, block->size,
+                                       (void *) (intptr_t) block_index);
+    }
+}
+
+/**
+ * Remueve un bloque del indice de bloques libres.
+ * @param block_index El indice del bloque.
+ * */
+void unindex_free_block(int block_index) {
+    MemoryBlock *block = block_at(memory->blocks, block_index);
+    bool removed = false;
+
+    if (memory->mode == BUDDY_MODE) {
+        removed = buddy_remove(block_index);
+    } else if (memory->mode == TLSF_MODE) {
+        removed = tlsf_remove(block_index);
+    } else if (block->free_node != NULL) {
+        tree_remove(memory->free_blocks, block->free_node);
+        block->free_node = NULL;
+        removed = true;
+    }
+
+    if (removed) {
+        count_free_block(block->size, -1);
+    }
+}
+
+/**
+ * Deja la tabla de bloques vacia y los indices de bloques libres sin bloques,
+ * para reconstruir la memoria bloque por bloque (por ejemplo, desde un snapshot).
+ * Solo se debe llamar cuando ningun proceso tiene memoria asignada.
+ * @param mode La forma de administracion de los bloques que se agreguen.
+ * */
+void empty_memory(enum MemoryMode mode) {
+    if (memory->blocks != NULL) {
+        clear_table(memory->blocks);
+        clear_tree(memory->free_blocks);
+    }
+    memory->blocks = create_table(64);
+    memory->free_blocks = create_tree();
+    memory->mode = mode;
+    memory->allocated_blocks = 0;
+    hash_reset(memory->owners);
+    memory->remaining_size = 0;
+    memory->free_count = 0;
+    for (int i = 0; i < SIZE_CLASSES; i++) {
+        memory->free_classes[i] = 0;
+    }
+    memory->cursor = NO_BLOCK;
+    memory->buddy_orders = 0;
+    for (int i = 0; i < BUDDY_ORDERS; i++) {
+        memory->buddy_lists[i] = NO_BLOCK;
+    }
+    memory->tlsf_first = 0;
+    for (int i = 0; i < TLSF_FL; i++) {
+        memory->tlsf_second[i] = 0;
+        for (int j = 0; j < TLSF_SL; j++) {
+            memory->tlsf_lists[i][j] = NO_BLOCK;
+        }
+    }
+}
+
+/**
+ * Reinicia los bloques de la memoria para administrarlos de otra forma.
+ * Solo se debe llamar cuando ningun proceso tiene memoria asignada.
+ * @param mode La nueva forma de administracion.
+ * */
+static void reset_memory(enum MemoryMode mode) {
+    empty_memory(mode);
+    if (mode == BUDDY_MODE) {
+        buddy_layout();
+    } else {
+        make_memory_block(NO_BLOCK, 0, memory->total_size);
+    }
+}
+
+/**
+ * Esta funcion libera la memoria simulada actual. Los procesos que tenian
+ * memoria asignada regresan al estado NEW.
+ * */
+void release_memory() {
+    if (memory->model == BITMAP_MODEL) {
+        for (int i = 0; i < memory->allocated_blocks; i++) {
+            memory->allocations[i].process->state = NEW;
+        }
+        clear_bitmap(memory->bitmap);
+        free(memory->allocations);
+    } else {
+        BlockTable *blocks = memory->blocks;
+        for (int i = blocks->head; i != NO_BLOCK; i = blocks->slots[i].next) {
+            if (blocks->slots[i].process != NULL) {
+                blocks->slots[i].process->state = NEW;
+            }
+        }
+        clear_table(blocks);
+        clear_tree(memory->free_blocks);
+    }
+    clear_hash(memory->owners);
+    release_backing(memory->backing);
+    free(memory);
+}
+
+/**
+ * Obtiene el numero de unidades que representa cada bit en el modelo de mapa
+ * de bits: la menor potencia de dos que mantiene el mapa en BITMAP_MAX_BITS bits.
+ * @param size El tamaño de la memoria.
+ * */
+long bitmap_unit_size(long size) {
+    long unit_size = 1;
+    while (size / unit_size > BITMAP_MAX_BITS) {
+        unit_size *= 2;
+    }
+    return unit_size;
+}
 
 /**
- * Esta funcion inicializa la memoria con un bloque de tamaño MAX_SIZE.
+ * Esta funcion inicializa la memoria con el numero de unidades libres indicado.
+ * Si ya existia una memoria, se libera y se reemplaza.
+ * @param model La forma en que se representa la memoria: una tabla de bloques
+ * o un mapa de bits.
+ * @param size El tamaño de la memoria. En el modelo de mapa de bits se redondea
+ * hacia abajo a un multiplo de las unidades que representa cada bit.
  * */
-void init_memory() {
+void init_memory(enum MemoryModel model, long size) {
+    // La generacion continua para que ningun indice de la memoria anterior parezca al dia.
+    long generation = 0;
+    if (memory != NULL) {
+        generation = memory->generation + 1;
+        release_memory();
+    }
+
     memory = (Memory *) malloc(sizeof(Memory));
-    memory->total_size = MAX_SIZE;
-    memory->remaining_size = MAX_SIZE;
-    memory->blocks = create_list();
+    memory->generation = generation;
+    memory->failure_rate = 0.0;
+    memory->failed_size = 0;
+    memory->backing = backing_enabled ? create_backing(size) : NULL;
+    memory->total_size = size;
+    memory->model = model;
+    memory->blocks = NULL;
+    memory->first_fit_stats = (ScanStats) {0, 0};
+    memory->next_fit_stats = (ScanStats) {0, 0};
+    memory->relocated_units = 0;
+    memory->relocated_blocks = 0;
+    memory->owners = create_hash(64);
+    strcpy(memory->partition_fit, "ff");
+    for (int i = 0; i < REALLOC_PATHS; i++) {
+        memory->reallocations[i] = 0;
+    }
+
+    if (model == BITMAP_MODEL) {
+        memory->unit_size = bitmap_unit_size(size);
+        memory->total_size = size - size % memory->unit_size;
+        memory->remaining_size = memory->total_size;
+        memory->mode = PARTITION_MODE;
+        memory->allocated_blocks = 0;
+        memory->bitmap = create_bitmap(memory->total_size / memory->unit_size);
+        memory->allocations_capacity = 64;
+        memory->allocations = (Allocation *) malloc(
+                memory->allocations_capacity * sizeof(Allocation));
+        return;
+    }
+    reset_memory(PARTITION_MODE);
+}
+
+/**
+ * Esta funcion simula First Fit en el modelo de mapa de bits. La busqueda de
+ * bits libres consecutivos revisa 64 bits por operacion; el tamaño del proceso
+ * se redondea hacia arriba a las unidades que representa cada bit.
+ * @param process El proceso a asignar.
+ * @return La base de la memoria asignada, -1 si no hay espacio.
+ * */
+static long bitmap_first_fit(Process *process) {
+    long unit_size = memory->unit_size;
+    long bits = (process->size + unit_size - 1) / unit_size;
+    long bit = bitmap_find_run(memory->bitmap, bits, 0);
+    if (bit < 0) {
+        return -1;
+    }
+
+    bitmap_set_run(memory->bitmap, bit, bits);
+    memory->remaining_size -= bits * unit_size;
+    memory->generation++;
+    if (memory->allocated_blocks == memory->allocations_capacity) {
+        memory->allocations_capacity *= 2;
+        memory->allocations = (Allocation *) realloc(
+                memory->allocations, memory->allocations_capacity * sizeof(Allocation));
+    }
+    hash_put(memory->owners, process->pid, memory->allocated_blocks);
+    memory->allocations[memory->allocated_blocks++] = (Allocation) {
+            .base = bit * unit_size,
+            .size = bits * unit_size,
+            .process = process
+    };
+    process->state = READY;
+    return bit * unit_size;
+}
+
+/**
+ * Libera la memoria de un proceso en el modelo de mapa de bits.
+ * Las unidades liberadas quedan unidas a las libres vecinas sin trabajo extra.
+ * @param pid El identificador del proceso.
+ * @return true si se libero la memoria, false en caso contrario.
+ * */
+static bool bitmap_free(int pid) {
+    int index = hash_get(memory->owners, pid);
+    if (index == NOT_FOUND) {
+        return false;
+    }
+
+    Allocation *allocation = &memory->allocations[index];
+    bitmap_clear_run(memory->bitmap, allocation->base / memory->unit_size,
+                     allocation->size / memory->unit_size);
+    allocation->process->state = NEW;
+    memory->remaining_size += allocation->size;
+    memory->generation++;
+    hash_remove(memory->owners, pid);
+
+    // Se reemplaza con la ultima asignacion para no recorrer el arreglo.
+    *allocation = memory->allocations[--memory->allocated_blocks];
+    if (index < memory->allocated_blocks) {
+        hash_put(memory->owners, allocation->process->pid, index);
+    }
+    return true;
+}
+
+static int compare_allocation(const void *data1, const void *data2) {
+    long base1 = ((Allocation *) data1)->base, base2 = ((Allocation *) data2)->base;
+    return (base1 > base2) - (base1 < base2);
+}
+
+/**
+ * Obtiene el ancho de las columnas numericas del reporte, que crece con el
+ * numero de digitos del tamaño de la memoria.
+ * */
+static int column_width() {
+    int digits = snprintf(NULL, 0, "%ld", memory->total_size);
+    return digits + 2 > 10 ? digits + 2 : 10;
+}
+
+/**
+ * Imprime los encabezados de la tabla de bloques.
+ * */
+static void print_report_header() {
+    int width = column_width();
+    printf("%6s %11s %*s %*s %*s %*s\n", "Block#", "Process ID", width, "Base",
+           width, "Limit", width > 16 ? width : 16, "Available space", width, "Size");
+}
+
+/**
+ * Imprime una fila de la tabla de bloques.
+ * @param number El numero del bloque.
+ * @param owner El identificador del proceso o "Free".
+ * @param base La base del bloque.
+ * @param size El tamaño del bloque.
+ * @param available El espacio del bloque que no ocupa su proceso.
+ * */
+static void print_report_row(int number, char *owner, long base, long size, long available) {
+    int width = column_width();
+    printf("%6d %11s %*ld %*ld %*ld %*ld\n", number, owner, width, base,
+           width, base + size - 1, width > 16 ? width : 16, available, width, size);
+}
+
+/**
+ * Reporta el modelo de mapa de bits con la misma tabla que el modelo de bloques:
+ * cada asignacion es un bloque y cada hueco entre asignaciones es un bloque libre.
+ * */
+static void report_bitmap() {
+    int count = memory->allocated_blocks;
+    Allocation *sorted = (Allocation *) malloc((count + 1) * sizeof(Allocation));
+    memcpy(sorted, memory->allocations, count * sizeof(Allocation));
+    qsort(sorted, count, sizeof(Allocation), compare_allocation);
+    // Asignacion centinela al final de la memoria para reportar el ultimo hueco.
+    sorted[count] = (Allocation) {.base = memory->total_size, .size = 0, .process = NULL};
+
+    print_report_header();
+
+    int number = 1;
+    long position = 0, internal_fragmentation = 0;
+    char pid[16];
+    for (int i = 0; i <= count; i++) {
+        Allocation *allocation = &sorted[i];
+        if (allocation->base > position) {
+            long size = allocation->base - position;
+            print_report_row(number++, "Free", position, size, size);
+        }
+        if (allocation->process != NULL) {
+            long remaining = allocation->size - allocation->process->size;
+            snprintf(pid, sizeof(pid), "%d", allocation->process->pid);
+            print_report_row(number++, pid, allocation->base, allocation->size, remaining);
+            internal_fragmentation += remaining;
+        }
+        position = allocation->base + allocation->size;
+    }
+    free(sorted);
 
-    MemoryBlock *block = (MemoryBlock *) malloc(sizeof(MemoryBlock));
-    block->size = MAX_SIZE;
-    block->base = 0;
-    block->limit = MAX_SIZE - 1;
-    block->remaining_size = MAX_SIZE;
-    block->process = NULL;
-    append(memory->blocks, block, sizeof(MemoryBlock));
+    // El redondeo de cada asignacion a las unidades de un bit.
+    printf("Internal fragmentation: %ld of %ld units (%ld units per bit)\n",
+           internal_fragmentation, memory->total_size, memory->unit_size);
+}
+
+/**
+ * Obtiene el nombre del asignador que corresponde a una forma de administracion.
+ * */
+static char *mode_name(enum MemoryMode mode) {
+    switch (mode) {
+        case BUDDY_MODE:
+            return "buddy";
+        case TLSF_MODE:
+            return "tlsf";
+        default:
+            return "partition";
+    }
+}
 
+/**
+ * Cambia la forma de administracion de la memoria si es necesario.
+ * Solo se puede cambiar cuando ningun proceso tiene memoria asignada.
+ * @param mode La forma de administracion que requiere el algoritmo.
+ * @return true si la memoria quedo en la forma indicada, false en caso contrario.
+ * */
+static bool use_mode(enum MemoryMode mode) {
+    if (memory->mode == mode) {
+        return true;
+    }
+    if (memory->allocated_blocks > 0) {
+        printf("Memory is managed by the %s allocator, free all processes first\n",
+               mode_name(memory->mode));
+        return false;
+    }
+    reset_memory(mode);
+    return true;
 }
 
 /**
@@ -28,28 +385,27 @@ void init_memory() {
  * @param block_index El indice del bloque.
  * @return El limite del bloque.
  * */
-int get_limit_from(int block_number) {
-    MemoryBlock *block = get_at(memory->blocks, block_number);
-    return block->process->size + block->base - 1;
+long get_limit_from(int block_index) {
+    MemoryBlock *block = block_at(memory->blocks, block_index);
+    return block->base + block->size - 1;
 }
 
 /**
  * Obtiene el tamaño de un bloque de memoria.
- * @param block_number El numero del bloque de memoria.
+ * @param block_index El indice del bloque de memoria.
  * @return El tamaño del bloque de memoria.
  * */
-int get_size_from(int block_number) {
-    MemoryBlock *block = get_at(memory->blocks, block_number);
-    return (block->limit + 1) - block->base;
+long get_size_from(int block_index) {
+    return block_at(memory->blocks, block_index)->size;
 }
 
 /**
  * Obtiene la memoria restante de un bloque de memoria.
- * @param block_number El numero del bloque de memoria.
+ * @param block_index El indice del bloque de memoria.
  * @return La memoria restante del bloque de memoria.
  * */
-int get_remaining_memory_from(int block_number) {
-    MemoryBlock *block = (MemoryBlock *) get_at(memory->blocks, block_number);
+long get_remaining_memory_from(int block_index) {
+    MemoryBlock *block = block_at(memory->blocks, block_index);
     Process *process = block->process;
 
     if (process == NULL) {
@@ -60,225 +416,857 @@ int get_remaining_memory_from(int block_number) {
 }
 
 /**
- * Esta funcion crea un bloque de memoria.
- * @param block_number El numero del bloque de memoria.
+ * Esta funcion crea un bloque de memoria libre despues del bloque indicado
+ * y lo agrega al indice de bloques libres.
+ * @param previous_index El indice del bloque anterior, NO_BLOCK si es el primero.
  * @param base La base del bloque de memoria.
- * @param limit El limite del bloque de memoria.
+ * @param size El tamaño del bloque de memoria.
+ * @return El indice del bloque creado.
  * */
-void make_memory_block(int block_number, int base, int limit) {
-    MemoryBlock *block = (MemoryBlock *) malloc(sizeof(MemoryBlock));
+int make_memory_block(int previous_index, long base, long size) {
+    int block_index = table_insert_after(memory->blocks, previous_index);
+    MemoryBlock *block = block_at(memory->blocks, block_index);
     block->base = base;
-    block->limit = limit;
-    block->remaining_size = limit - base;
-    block->size = block->remaining_size;
-    block->process = NULL;
-    add_at(memory->blocks, block,
-           block_number, sizeof(MemoryBlock));
+    block->size = size;
+    index_free_block(block_index);
+    return block_index;
 }
 
 /**
  * Esta funcion asigna un proceso a un bloque de memoria.
- * @param pid El identificador del proceso.
- * @param size El tamaño del proceso.
- * @param block_number El numero del bloque de memoria.
+ * Si sobra espacio, el sobrante se separa en un nuevo bloque libre.
+ * @param block_index El indice del bloque de memoria.
+ * @param process El proceso a asignar.
  * @return true si se asigno el proceso, false en caso contrario.
  * */
 bool assign_to_block(int block_index, Process *process) {
-    long remaining_memory = get_remaining_memory_from(block_index);
+    MemoryBlock *block = block_at(memory->blocks, block_index);
 
-    /* Si el tamaño del proceso es mayor a la memoria restante
-     * del bloque de memoria, entonces no se puede asignar el proceso. */
-    if (remaining_memory < process->size) {
+    /* Si el bloque esta ocupado o el tamaño del proceso es mayor a la
+     * memoria restante del bloque, entonces no se puede asignar el proceso. */
+    if (block->process != NULL || block->size < process->size) {
         return false;
     }
-    // Se crea el proceso y se asigna al bloque de memoria.
-//    Process *process = (Process *) malloc(sizeof(Process));
-//    process->pid = malloc(sizeof(char) * strlen(pid));
-//    strcpy(process->pid, pid);
-//    process->size = size;
-    MemoryBlock *block = (MemoryBlock *) get_at(memory->blocks, block_index);
+
+    unindex_free_block(block_index);
     block->process = process;
     block->process->state = READY;
 
-    // Se crea un nuevo bloque de memoria si hay suficiente memoria restante.
-    if (remaining_memory > 0) {
-        int new_block_limit = block->limit;
-        block->limit = get_limit_from(block_index);
-        block->size = get_size_from(block_index);
-        block->remaining_size = get_remaining_memory_from(block_index);
-        int new_block_base = block->limit + 1;
+    memory->allocated_blocks++;
+    hash_put(memory->owners, process->pid, block_index);
 
-        make_memory_block(block_index + 1,
-                          new_block_base, new_block_limit);
+    // Se crea un nuevo bloque de memoria con el espacio sobrante.
+    if (block->size > process->size) {
+        long remaining = block->size - process->size;
+        block->size = process->size;
+        make_memory_block(block_index, block->base + process->size, remaining);
     }
     return true;
 }
 
 /**
- * Esta funcion libera la memoria de un proceso.
+ * Remueve de la tabla un bloque que fue absorbido por su vecino.
+ * @param block_index El indice del bloque absorbido.
+ * @param survivor El indice del bloque que lo absorbio.
+ * */
+static void remove_memory_block(int block_index, int survivor) {
+    table_remove(memory->blocks, block_index);
+    // El cursor de next fit pasa al bloque que absorbio al suyo.
+    if (memory->cursor == block_index) {
+        memory->cursor = survivor;
+    }
+}
+
+/**
+ * Une un bloque recien liberado con sus vecinos libres en O(1) y lo agrega al
+ * indice de bloques libres. Los enlaces previous/next de la tabla funcionan como
+ * etiquetas de frontera, por lo que nunca quedan huecos libres adyacentes.
+ * @param block_index El indice del bloque liberado, que aun no esta en el indice.
+ * @return El indice del bloque resultante.
+ * */
+int coalesce_block(int block_index) {
+    BlockTable *blocks = memory->blocks;
+    MemoryBlock *block = block_at(blocks, block_index);
+
+    int next = block->next;
+    if (next != NO_BLOCK && block_at(blocks, next)->process == NULL) {
+        unindex_free_block(next);
+        block->size += block_at(blocks, next)->size;
+        remove_memory_block(next, block_index);
+    }
+
+    int previous = block->previous;
+    if (previous != NO_BLOCK && block_at(blocks, previous)->process == NULL) {
+        unindex_free_block(previous);
+        block_at(blocks, previous)->size += block->size;
+        remove_memory_block(block_index, previous);
+        block_index = previous;
+    }
+
+    index_free_block(block_index);
+    return block_index;
+}
+
+/**
+ * Deja libre un bloque asignado y lo une con sus vecinos libres.
+ * El proceso del bloque y el indice por pid no se modifican.
+ * @param block_index El indice del bloque.
+ * */
+static void release_block(int block_index) {
+    block_at(memory->blocks, block_index)->process = NULL;
+    memory->allocated_blocks--;
+
+    /* En el sistema buddy el bloque solo se une con su buddy;
+     * en los demas se une con cualquier vecino libre. */
+    if (memory->mode == BUDDY_MODE) {
+        buddy_merge(block_index);
+    } else {
+        coalesce_block(block_index);
+    }
+}
+
+/**
+ * Esta funcion libera la memoria de un proceso. El bloque del proceso se
+ * obtiene del indice por pid en O(1), sin recorrer la tabla.
  * @param pid El identificador del proceso.
  * @return true si se libero la memoria, false en caso contrario.
  * */
 bool free_memory(int pid) {
-    for (int i = 0; i < memory->blocks->size; i++) {
-        MemoryBlock *block = get_at(memory->blocks, i);
-        if (block->process != NULL && block->process->pid == pid) {
-            block->process->state = NEW;
-            block->process = NULL;
-            block->remaining_size = block->size;
-            return true;
+    if (memory->model == BITMAP_MODEL) {
+        return bitmap_free(pid);
+    }
+
+    int block_index = hash_get(memory->owners, pid);
+    if (block_index == NOT_FOUND) {
+        return false;
+    }
+
+    block_at(memory->blocks, block_index)->process->state = NEW;
+    hash_remove(memory->owners, pid);
+    release_block(block_index);
+    return true;
+}
+
+/**
+ * Reacomoda la tabla en orden de direccion para que los recorridos sean
+ * secuenciales, actualizando los indices guardados en el arbol, el indice
+ * por pid y el cursor.
+ * Solo se usa en PARTITION_MODE; las listas de buddy y TLSF tambien guardan indices.
+ * */
+static void repack_blocks() {
+    BlockTable *blocks = memory->blocks;
+    long cursor_base = memory->cursor != NO_BLOCK ? blocks->slots[memory->cursor].base : -1;
+
+    table_repack(blocks);
+    for (int i = blocks->head; i != NO_BLOCK; i = blocks->slots[i].next) {
+        if (blocks->slots[i].free_node != NULL) {
+            blocks->slots[i].free_node->data = (void *) (intptr_t) i;
+        }
+        if (blocks->slots[i].process != NULL) {
+            hash_put(memory->owners, blocks->slots[i].process->pid, i);
+        }
+        if (blocks->slots[i].base == cursor_base) {
+            memory->cursor = i;
         }
     }
-    return false;
 }
 
 /**
- * Esta funcion compacta la memoria.
+ * Calcula donde queda cada segmento asignado despues de compactar. Los primeros
+ * `split` segmentos se empujan hacia la direccion 0 y los demas hacia el final,
+ * sin cambiar su orden, de modo que queda un solo hueco libre entre ambos grupos.
+ * Con COMPACT_MIN_MOVES se prueban todas las divisiones en O(n) y se elige la
+ * que mueve menos unidades; un segmento que ya esta en su lugar no cuesta nada.
+ * @param segments Los segmentos asignados en orden de direccion; al terminar
+ * su base es la nueva base.
+ * @param count El numero de segmentos.
+ * @param policy Hacia donde se mueven los segmentos.
+ * @param moved_units Donde se guarda el numero de unidades movidas.
+ * @param moved_blocks Donde se guarda el numero de segmentos movidos.
+ * @return El numero de segmentos que se empujan hacia la direccion 0.
  * */
-void compact_memory() {
-    // Se recorre la lista de bloques de memoria.
-    for (int i = 0; i < memory->blocks->size; i++) {
-        long remaining_memory = get_remaining_memory_from(i);
-        // Si hay memoria restante, se compacta.
-        if (remaining_memory > 0) {
-            // Se verifica si se puede compactar con el bloque anterior.
-            if (i > 0) {
-                if (get_remaining_memory_from(i - 1) > 0) {
-                    MemoryBlock *block = get_at(memory->blocks, i);
-                    MemoryBlock *previous_block = get_at(memory->blocks, i - 1);
-                    block->size = block->size + previous_block->size;
-                    block->base = previous_block->base;
-                    block->remaining_size = block->size;
-                    remove_element_at(memory->blocks, i - 1);
-                }
-            }
-            // Se verifica si se puede compactar con el bloque siguiente.
-            if (i < memory->blocks->size - 1) {
-                if (get_remaining_memory_from(i + 1) > 0) {
-                    MemoryBlock *block = get_at(memory->blocks, i);
-                    MemoryBlock *next_block = get_at(memory->blocks, i + 1);
-                    block->size = block->size + next_block->size;
-                    block->limit = next_block->limit;
-                    block->remaining_size = block->size;
-                    remove_element_at(memory->blocks, i + 1);
-                }
-            }
+static int plan_compaction(Allocation *segments, int count, enum CompactionPolicy policy,
+                           long *moved_units, int *moved_blocks) {
+    long total = 0;
+    for (int i = 0; i < count; i++) {
+        total += segments[i].size;
+    }
+    long gap = memory->total_size - total;
+
+    // Costo de empujar hacia el final todos los segmentos a partir de i.
+    long *high_cost = (long *) malloc((count + 1) * sizeof(long));
+    high_cost[count] = 0;
+    long offset = total;
+    for (int i = count - 1; i >= 0; i--) {
+        offset -= segments[i].size;
+        bool moves = gap + offset != segments[i].base;
+        high_cost[i] = high_cost[i + 1] + (moves ? segments[i].size : 0);
+    }
+
+    int split = 0;
+    long low_cost = 0, best_cost = high_cost[0];
+    offset = 0;
+    for (int i = 0; i < count; i++) {
+        low_cost += offset != segments[i].base ? segments[i].size : 0;
+        offset += segments[i].size;
+        if (low_cost + high_cost[i + 1] <= best_cost) {
+            best_cost = low_cost + high_cost[i + 1];
+            split = i + 1;
+        }
+    }
+    if (policy == COMPACT_TO_BASE) {
+        split = count;
+        best_cost = low_cost;
+    }
+    free(high_cost);
+
+    // Se asignan las nuevas bases.
+    *moved_units = best_cost;
+    *moved_blocks = 0;
+    offset = 0;
+    for (int i = 0; i < count; i++) {
+        long base = i < split ? offset : gap + offset;
+        if (base != segments[i].base) {
+            (*moved_blocks)++;
         }
+        segments[i].base = base;
+        offset += segments[i].size;
     }
+    return split;
 }
 
 /**
- * Esta funcion simula el algoritmo de asignacion de memoria First Fit.
- * @param pid El identificador del proceso.
- * @param size El tamaño del proceso.
- * */
-void best_fit(Process *process) {
-    MemoryBlock *best_block = memory->blocks->head->data;
-    int best_block_index = 0;
-
-    for (int i = 0; i < memory->blocks->size; i++) {
-        MemoryBlock *block = get_at(memory->blocks, i);
-        /* Si el bloque de memoria no tiene un proceso asignado y
-         * el tamaño del bloque es mayor al tamaño del proceso,
-         * entonces ese es el mejor bloque de memoria.
-         * */
-        if (block->process == NULL && block->remaining_size >= best_block->remaining_size) {
-            best_block = block;
-            best_block_index = i;
+ * Mueve los bytes reales de los segmentos compactados a su nueva base. Los que
+ * se empujan hacia la direccion 0 se mueven en orden de direccion y los demas en
+ * orden inverso, para que ninguno pise a otro que aun no se mueve.
+ * @param old_bases La base de cada segmento antes de compactar.
+ * @param segments Los segmentos con su nueva base.
+ * @param count El numero de segmentos.
+ * @param split El numero de segmentos que se empujan hacia la direccion 0.
+ * */
+static void move_segments(long *old_bases, Allocation *segments, int count, int split) {
+    for (int i = 0; i < split; i++) {
+        move_region(memory->backing, old_bases[i], segments[i].base, segments[i].process->size);
+    }
+    for (int i = count - 1; i >= split; i--) {
+        move_region(memory->backing, old_bases[i], segments[i].base, segments[i].process->size);
+    }
+}
+
+/**
+ * Guarda la base de cada segmento antes de compactar, si hay bytes reales que mover.
+ * @return Las bases, NULL si la memoria no tiene bytes reales.
+ * */
+static long *save_bases(Allocation *segments, int count) {
+    if (memory->backing == NULL) {
+        return NULL;
+    }
+    long *bases = (long *) malloc((count + 1) * sizeof(long));
+    for (int i = 0; i < count; i++) {
+        bases[i] = segments[i].base;
+    }
+    return bases;
+}
+
+/**
+ * Compacta la tabla de bloques siguiendo un plan: mueve los bloques asignados
+ * a su nueva base y reemplaza todos los bloques libres por un solo bloque.
+ * */
+static void compact_blocks(enum CompactionPolicy policy, long *moved_units, int *moved_blocks) {
+    BlockTable *blocks = memory->blocks;
+    Allocation *segments = (Allocation *) malloc((memory->allocated_blocks + 1) * sizeof(Allocation));
+    int count = 0;
+
+    for (int i = blocks->head; i != NO_BLOCK; i = blocks->slots[i].next) {
+        MemoryBlock *block = &blocks->slots[i];
+        if (block->process != NULL) {
+            segments[count++] = (Allocation) {block->base, block->size, block->process};
         }
     }
+    long *old_bases = save_bases(segments, count);
+    int split = plan_compaction(segments, count, policy, moved_units, moved_blocks);
+    if (old_bases != NULL) {
+        move_segments(old_bases, segments, count, split);
+        free(old_bases);
+    }
 
-    for (int i = 0; i < memory->blocks->size; i++) {
-        MemoryBlock *block = get_at(memory->blocks, i);
-        /* Si el espacio restante del bloque de memoria es menor al espacio restante
-         * del mejor bloque de memoria y el espacio restante del bloque de memoria
-         * es mayor al tamaño del proceso, entonces ese es el mejor bloque de memoria.
-         * */
-        if (block->remaining_size < best_block->remaining_size
-            && block->remaining_size > process->size) {
-            best_block = block;
-            best_block_index = i;
+    // Se mueven los bloques asignados y se remueven los libres.
+    int position = 0, anchor = NO_BLOCK;
+    for (int i = blocks->head; i != NO_BLOCK;) {
+        int next = blocks->slots[i].next;
+        if (blocks->slots[i].process == NULL) {
+            unindex_free_block(i);
+            table_remove(blocks, i);
+            if (memory->cursor == i) {
+                memory->cursor = NO_BLOCK;
+            }
+        } else {
+            blocks->slots[i].base = segments[position].base;
+            if (++position == split) {
+                anchor = i;
+            }
         }
+        i = next;
+    }
+
+    // El unico hueco queda entre los bloques empujados hacia cada extremo.
+    long free_size = memory->total_size;
+    for (int i = 0; i < count; i++) {
+        free_size -= segments[i].size;
+    }
+    if (free_size > 0) {
+        long base = split < count ? segments[split].base - free_size : memory->total_size - free_size;
+        make_memory_block(anchor, base, free_size);
+    }
+    free(segments);
+}
+
+/**
+ * Compacta el modelo de mapa de bits siguiendo un plan: mueve las asignaciones
+ * y vuelve a marcar las unidades ocupadas.
+ * */
+static void compact_bitmap(enum CompactionPolicy policy, long *moved_units, int *moved_blocks) {
+    int count = memory->allocated_blocks;
+    qsort(memory->allocations, count, sizeof(Allocation), compare_allocation);
+    long *old_bases = save_bases(memory->allocations, count);
+    int split = plan_compaction(memory->allocations, count, policy, moved_units, moved_blocks);
+    if (old_bases != NULL) {
+        move_segments(old_bases, memory->allocations, count, split);
+        free(old_bases);
+    }
+    for (int i = 0; i < count; i++) {
+        hash_put(memory->owners, memory->allocations[i].process->pid, i);
+    }
+
+    long unit_size = memory->unit_size;
+    bitmap_clear_run(memory->bitmap, 0, memory->total_size / unit_size);
+    for (int i = 0; i < count; i++) {
+        bitmap_set_run(memory->bitmap, memory->allocations[i].base / unit_size,
+                       memory->allocations[i].size / unit_size);
     }
-    // Se asigna el proceso al mejor bloque de memoria.
-    if (assign_to_block(best_block_index, process) == true) {
-        printf("Process %d assigned to block %d\n",
-               process->pid, best_block_index + 1);
+    memory->generation++;
+}
+
+/**
+ * Esta funcion compacta la memoria moviendo los bloques asignados para que
+ * toda la memoria libre quede en un solo hueco. Los bloques libres adyacentes
+ * ya se unen al liberarse, asi que esto solo recupera la fragmentacion externa
+ * que queda entre bloques asignados.
+ * @param policy Hacia donde se mueven los bloques.
+ * */
+void compact_memory(enum CompactionPolicy policy) {
+    long moved_units = 0;
+    int moved_blocks = 0;
+    long copied_bytes = memory->backing != NULL ? memory->backing->copied_bytes : 0;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if (memory->model == BITMAP_MODEL) {
+        compact_bitmap(policy, &moved_units, &moved_blocks);
+    } else if (memory->mode == BUDDY_MODE) {
+        // Mover un bloque buddy rompe su alineacion.
+        printf("Blocks cannot be relocated in buddy mode\n");
+        return;
     } else {
-        printf("Process %d could not be assigned to block %d\n",
-               process->pid, best_block_index + 1);
+        compact_blocks(policy, &moved_units, &moved_blocks);
+        if (memory->mode == PARTITION_MODE) {
+            repack_blocks();
+        }
+    }
+
+    memory->relocated_units += moved_units;
+    memory->relocated_blocks += moved_blocks;
+    printf("Compaction moved %ld units in %d blocks\n", moved_units, moved_blocks);
+    if (memory->backing != NULL) {
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double seconds = (double) (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        copied_bytes = memory->backing->copied_bytes - copied_bytes;
+        printf("Copied %ld bytes, compaction took %.3f ms (%.2f GB/s)\n", copied_bytes, seconds * 1e3,
+               seconds > 0 ? (double) copied_bytes / seconds / 1e9 : 0.0);
+    }
+}
+
+/**
+ * Esta funcion simula el algoritmo de asignacion de memoria Best Fit.
+ * El bloque se obtiene del indice de bloques libres en O(log n).
+ * @param process El proceso a asignar.
+ * @return El indice del bloque asignado, NO_BLOCK si no hay espacio.
+ * */
+int best_fit(Process *process) {
+    // El menor bloque libre cuyo espacio restante alcance para el proceso.
+    TreeNode *best = tree_lower_bound(memory->free_blocks, process->size);
+    int block_index = best != NULL ? block_of(best) : NO_BLOCK;
+
+    if (block_index != NO_BLOCK && assign_to_block(block_index, process) == true) {
+        return block_index;
     }
+    return NO_BLOCK;
 }
 
 /**
  * Esta funcion simula el algoritmo de asignacion de memoria Worst Fit.
- * @param pid El identificador del proceso.
- * @param size El tamaño del proceso.
- * */
-void worst_fit(Process *process) {
-    MemoryBlock *worst_block = memory->blocks->head->data;
-    int worst_block_index = 0;
-    for (int i = 0; i < memory->blocks->size; i++) {
-        MemoryBlock *block = get_at(memory->blocks, i);
-        /* Si el espacio restante del bloque de memoria es mayor al del
-         * peor bloque de memoria y el espacio restante del bloque de memoria
-         * es mayor al tamaño del proceso, entonces ese es el peor bloque de memoria.
-         * */
-        if (block->remaining_size > worst_block->remaining_size && block->remaining_size > process->size) {
-            worst_block = block;
-            worst_block_index = i;
+ * El bloque libre mas grande se obtiene del indice en O(1).
+ * @param process El proceso a asignar.
+ * @return El indice del bloque asignado, NO_BLOCK si no hay espacio.
+ * */
+int worst_fit(Process *process) {
+    TreeNode *worst = tree_last(memory->free_blocks);
+    int block_index = worst != NULL && worst->key >= process->size
+                      ? block_of(worst) : NO_BLOCK;
+
+    if (block_index != NO_BLOCK && assign_to_block(block_index, process) == true) {
+        return block_index;
+    }
+    return NO_BLOCK;
+}
+
+/**
+ * Esta funcion simula el algoritmo de asignacion de memoria First Fit.
+ * @param process El proceso a asignar.
+ * @return El indice del bloque asignado, NO_BLOCK si no hay espacio.
+ * */
+int first_fit(Process *process) {
+    BlockTable *blocks = memory->blocks;
+    int i = blocks->head;
+
+    // Se busca el primer bloque libre que tenga espacio suficiente.
+    memory->first_fit_stats.searches++;
+    while (i != NO_BLOCK
+           && (blocks->slots[i].process != NULL || blocks->slots[i].size < process->size)) {
+        memory->first_fit_stats.scanned++;
+        i = blocks->slots[i].next;
+    }
+    if (i != NO_BLOCK) {
+        memory->first_fit_stats.scanned++;
+    }
+
+    // Se asigna el proceso al bloque de memoria.
+    if (i != NO_BLOCK && assign_to_block(i, process) == true) {
+        return i;
+    }
+    return NO_BLOCK;
+}
+
+/**
+ * Esta funcion simula el algoritmo de asignacion de memoria Next Fit.
+ * La busqueda inicia donde termino la anterior y da la vuelta al llegar al final,
+ * en lugar de volver a revisar siempre los primeros bloques.
+ * @param process El proceso a asignar.
+ * @return El indice del bloque asignado, NO_BLOCK si no hay espacio.
+ * */
+int next_fit(Process *process) {
+    BlockTable *blocks = memory->blocks;
+    int start = memory->cursor != NO_BLOCK ? memory->cursor : blocks->head;
+    int i = start;
+
+    memory->next_fit_stats.searches++;
+    do {
+        memory->next_fit_stats.scanned++;
+        MemoryBlock *block = &blocks->slots[i];
+        if (block->process == NULL && block->size >= process->size) {
+            break;
         }
+        i = block->next != NO_BLOCK ? block->next : blocks->head;
+    } while (i != start);
+
+    if (block_at(blocks, i)->process == NULL && assign_to_block(i, process) == true) {
+        // La siguiente busqueda inicia en el sobrante del bloque asignado.
+        MemoryBlock *block = block_at(blocks, i);
+        memory->cursor = block->next != NO_BLOCK ? block->next : blocks->head;
+        return i;
     }
-    // Se asigna el proceso al mejor bloque de memoria.
-    if (assign_to_block(worst_block_index, process) == true) {
-        printf("Process %d assigned to block %d\n",
-               process->pid, worst_block_index + 1);
+    return NO_BLOCK;
+}
+
+/**
+ * Obtiene la forma de administracion que requiere un algoritmo de asignacion.
+ * @param fit El nombre del algoritmo.
+ * @param mode Donde se guarda la forma de administracion.
+ * @return true si el algoritmo existe, false en caso contrario.
+ * */
+static bool mode_of_fit(char *fit, enum MemoryMode *mode) {
+    if (strcmp(fit, "ff") == 0 || strcmp(fit, "nf") == 0
+        || strcmp(fit, "bf") == 0 || strcmp(fit, "wf") == 0) {
+        *mode = PARTITION_MODE;
+    } else if (strcmp(fit, "buddy") == 0) {
+        *mode = BUDDY_MODE;
+    } else if (strcmp(fit, "tlsf") == 0) {
+        *mode = TLSF_MODE;
     } else {
-        printf("Process %d could not be assigned to block %d\n",
-               process->pid, worst_block_index + 1);
+        return false;
     }
+    return true;
 }
 
 /**
- * Esta funcion simula el algoritmo de asignacion de memoria First Fit.
- * @param pid El identificador del proceso.
- * @param size El tamaño del proceso.
- * */
-void first_fit(Process *process) {
-    // Si la lista de bloques de memoria no esta vacia.
-    if (!is_list_empty(memory->blocks)) {
-        int i = 0;
-        MemoryBlock *block = get_at(memory->blocks, i);
-        // Se busca el primer bloque de memoria que tenga espacio suficiente.
-        while (block->remaining_size < process->size || i < memory->blocks->size - 1) {
-            block = get_at(memory->blocks, ++i);
-        }
-        // Se asigna el proceso al bloque de memoria.
-        if (assign_to_block(i, process) == true) {
-            printf("Process %d assigned to block %d\n",
-                   process->pid, i);
-        } else {
-            printf("Memory is full\n");
+ * Esta funcion prepara la memoria para un algoritmo de asignacion: comprueba
+ * que exista y que el modelo lo soporte, y cambia la forma de administracion
+ * si es necesario. Imprime el motivo si no se puede usar.
+ * @param fit El nombre del algoritmo.
+ * @return true si la memoria quedo lista para el algoritmo, false en caso contrario.
+ * */
+bool select_fit(char *fit) {
+    enum MemoryMode mode;
+
+    if (!mode_of_fit(fit, &mode)) {
+        printf("Invalid fit\n");
+        return false;
+    }
+    if (memory->model == BITMAP_MODEL) {
+        if (strcmp(fit, "ff") != 0) {
+            printf("The bitmap model only supports first fit (ff)\n");
+            return false;
         }
+        return true;
+    }
+    if (!use_mode(mode)) {
+        return false;
+    }
+    // Se guarda una copia porque fit puede apuntar a la entrada del usuario.
+    if (mode == PARTITION_MODE) {
+        strcpy(memory->partition_fit, fit);
+    }
+    return true;
+}
+
+/**
+ * Asigna un bloque a un proceso con el algoritmo indicado en el modelo de bloques.
+ * @return El indice del bloque asignado, NO_BLOCK si no hay espacio.
+ * */
+static int fit_block(Process *process, char *fit) {
+    if (strcmp(fit, "ff") == 0) {
+        return first_fit(process);
+    } else if (strcmp(fit, "nf") == 0) {
+        return next_fit(process);
+    } else if (strcmp(fit, "bf") == 0) {
+        return best_fit(process);
+    } else if (strcmp(fit, "wf") == 0) {
+        return worst_fit(process);
+    } else if (strcmp(fit, "buddy") == 0) {
+        return buddy_alloc(process);
+    }
+    return tlsf_alloc(process);
+}
+
+/**
+ * Esta funcion obtiene el algoritmo con el que se administra la memoria: el de
+ * su forma de administracion o, en particiones, el ultimo que se uso.
+ * */
+char *current_fit() {
+    return memory->mode == BUDDY_MODE ? "buddy"
+           : memory->mode == TLSF_MODE ? "tlsf" : memory->partition_fit;
+}
+
+/**
+ * Esta funcion asigna memoria a un proceso sin imprimir nada, para reproducir
+ * trazas sin el costo de la salida. La memoria ya debe estar lista para el
+ * algoritmo (select_fit).
+ * @param process El proceso a asignar.
+ * @param fit El algoritmo de asignacion de memoria.
+ * @return La base de la memoria asignada, -1 si no se pudo asignar.
+ * */
+long allocate_memory(Process *process, char *fit) {
+    if (process->size <= 0 || process->size > memory->total_size
+        || hash_get(memory->owners, process->pid) != NOT_FOUND) {
+        return -1;
     }
+
+    long base;
+    if (memory->model == BITMAP_MODEL) {
+        base = bitmap_first_fit(process);
+    } else {
+        int block_index = fit_block(process, fit);
+        base = block_index != NO_BLOCK ? block_at(memory->blocks, block_index)->base : -1;
+    }
+    memory->failure_rate += ((base < 0 ? 1.0 : 0.0) - memory->failure_rate) / FAILURE_RATE_WINDOW;
+    if (base < 0) {
+        memory->failed_size = process->size;
+    } else if (memory->backing != NULL) {
+        fill_region(memory->backing, process, base, 0, process->size);
+    }
+    return base;
 }
 
 /**
  * Esta funcion asigna un proceso a un bloque de memoria,
  * utilizando el algoritmo de asignacion de memoria especificado.
- * @param pid El identificador del proceso.
- * @param size El tamaño del proceso.
+ * @param process El proceso a asignar.
  * @param fit El algoritmo de asignacion de memoria.
  * */
 void assign_memory(Process *process, char *fit) {
-    if (strcmp(fit, "ff") == 0) {
-        first_fit(process);
-    } else if (strcmp(fit, "bf") == 0) {
-        best_fit(process);
-    } else if (strcmp(fit, "wf") == 0) {
-        worst_fit(process);
-    } else{
-        printf("Invalid fit\n");
+    if (process->size <= 0) {
+        printf("Invalid process size\n");
+        return;
+    }
+    if (process->size > memory->total_size) {
+        printf("Process %d is larger than the memory\n", process->pid);
+        return;
+    }
+    if (hash_get(memory->owners, process->pid) != NOT_FOUND) {
+        printf("Process %d already has memory assigned\n", process->pid);
+        return;
+    }
+    // Un proceso en el swap regresa con sus bytes en lugar de recibir memoria nueva.
+    if (process->state == SWAPPED) {
+        if (swap_in(process)) {
+            printf("Process %d swapped in at base %ld\n", process->pid, base_of(process));
+        } else {
+            printf("Process %d could not be swapped in\n", process->pid);
+        }
+        return;
+    }
+    if (!select_fit(fit)) {
+        return;
+    }
+
+    long base = allocate_memory(process, fit);
+    if (base < 0 && swap_area != NULL) {
+        base = allocate_with_swap(process, fit);
+    }
+    if (base < 0) {
+        // First fit y next fit recorren toda la memoria antes de fallar.
+        if (strcmp(fit, "ff") == 0 || strcmp(fit, "nf") == 0) {
+            printf("Memory is full\n");
+        } else {
+            printf("Process %d could not be assigned\n", process->pid);
+        }
+    } else if (memory->mode == BUDDY_MODE) {
+        MemoryBlock *block = block_at(memory->blocks, hash_get(memory->owners, process->pid));
+        printf("Process %d assigned to block at base %ld (size %ld, %ld wasted)\n",
+               process->pid, base, block->size, block->size - process->size);
+    } else {
+        printf("Process %d assigned to block at base %ld\n", process->pid, base);
+    }
+}
+
+/**
+ * Reduce en su lugar el bloque de un proceso. En el sistema buddy se separan
+ * mitades superiores hasta llegar al orden del nuevo tamaño; en los demas el
+ * sobrante se separa en un bloque libre que se une con el siguiente si esta libre.
+ * @param block_index El indice del bloque.
+ * @param size El nuevo tamaño del proceso, menor o igual al del bloque.
+ * */
+static void shrink_block(int block_index, long size) {
+    MemoryBlock *block = block_at(memory->blocks, block_index);
+
+    if (memory->mode == BUDDY_MODE) {
+        long target = 1L << buddy_order(size);
+        while (block->size > target) {
+            block->size /= 2;
+            make_memory_block(block_index, block->base + block->size, block->size);
+            block = block_at(memory->blocks, block_index);
+        }
+    } else if (block->size > size) {
+        int tail = table_insert_after(memory->blocks, block_index);
+        block = block_at(memory->blocks, block_index);
+        block_at(memory->blocks, tail)->base = block->base + size;
+        block_at(memory->blocks, tail)->size = block->size - size;
+        block->size = size;
+        coalesce_block(tail);
+    }
+}
+
+/**
+ * Hace crecer en su lugar el bloque de un proceso tomando memoria del bloque
+ * siguiente, si esta libre y alcanza. En el sistema buddy el bloque solo crece
+ * uniendose con sus buddies, que deben estar libres y completos.
+ * @param block_index El indice del bloque.
+ * @param size El nuevo tamaño del proceso, mayor al del bloque.
+ * @return true si el bloque crecio, false si no cambio.
+ * */
+static bool grow_block(int block_index, long size) {
+    BlockTable *blocks = memory->blocks;
+    MemoryBlock *block = block_at(blocks, block_index);
+
+    if (memory->mode == BUDDY_MODE) {
+        long target = 1L << buddy_order(size);
+        // Primero se comprueba que todos los buddies necesarios esten libres.
+        int next = block->next;
+        for (long span = block->size; span < target; span *= 2) {
+            if (block->base % (2 * span) != 0 || next == NO_BLOCK
+                || block_at(blocks, next)->process != NULL || block_at(blocks, next)->size != span) {
+                return false;
+            }
+            next = block_at(blocks, next)->next;
+        }
+        while (block->size < target) {
+            next = block->next;
+            unindex_free_block(next);
+            block->size *= 2;
+            remove_memory_block(next, block_index);
+        }
+        return true;
+    }
+
+    int next = block->next;
+    if (next == NO_BLOCK || block_at(blocks, next)->process != NULL
+        || block->size + block_at(blocks, next)->size < size) {
+        return false;
+    }
+
+    // El bloque siguiente cede el inicio; si se usa completo, desaparece.
+    long extra = size - block->size;
+    MemoryBlock *neighbour = block_at(blocks, next);
+    unindex_free_block(next);
+    block->size = size;
+    if (neighbour->size == extra) {
+        remove_memory_block(next, block_index);
+    } else {
+        neighbour->base += extra;
+        neighbour->size -= extra;
+        index_free_block(next);
+    }
+    return true;
+}
+
+/**
+ * Cambia el tamaño de una asignacion del modelo de mapa de bits: se reduce o
+ * crece en su lugar si los bits siguientes estan libres y, si no, se mueve a
+ * la primera secuencia de bits libres que alcance.
+ * */
+static enum ReallocPath reallocate_bits(int index, long size) {
+    Allocation *allocation = &memory->allocations[index];
+    Bitmap *bitmap = memory->bitmap;
+    long unit_size = memory->unit_size;
+    long start = allocation->base / unit_size, bits = allocation->size / unit_size;
+    long new_bits = (size + unit_size - 1) / unit_size;
+    enum ReallocPath path;
+
+    if (new_bits <= bits) {
+        bitmap_clear_run(bitmap, start + new_bits, bits - new_bits);
+        path = REALLOC_SHRUNK;
+    } else if (bitmap_next_set(bitmap, start + bits) >= start + new_bits) {
+        bitmap_set_run(bitmap, start + bits, new_bits - bits);
+        path = REALLOC_GREW;
+    } else {
+        long bit = bitmap_find_run(bitmap, new_bits, 0);
+        if (bit < 0) {
+            return REALLOC_FAILED;
+        }
+        bitmap_set_run(bitmap, bit, new_bits);
+        bitmap_clear_run(bitmap, start, bits);
+        if (memory->backing != NULL) {
+            long kept = size < allocation->process->size ? size : allocation->process->size;
+            move_region(memory->backing, allocation->base, bit * unit_size, kept);
+        }
+        memory->relocated_units += allocation->size;
+        memory->relocated_blocks++;
+        allocation->base = bit * unit_size;
+        path = REALLOC_MOVED;
+    }
+
+    memory->remaining_size -= (new_bits - bits) * unit_size;
+    allocation->size = new_bits * unit_size;
+    memory->generation++;
+    return path;
+}
+
+/**
+ * Esta funcion obtiene la direccion donde inicia la memoria de un proceso.
+ * @param process El proceso, que debe tener memoria asignada.
+ * */
+long base_of(Process *process) {
+    int index = hash_get(memory->owners, process->pid);
+    if (memory->model == BITMAP_MODEL) {
+        return memory->allocations[index].base;
+    }
+    return block_at(memory->blocks, index)->base;
+}
+
+/**
+ * Esta funcion cambia el tamaño de la memoria de un proceso sin imprimir nada.
+ * Primero intenta hacerlo en su lugar: reduciendo el bloque o haciendolo crecer
+ * sobre el bloque libre siguiente. Solo si no se puede, mueve el proceso con el
+ * algoritmo de asignacion actual; si tampoco hay espacio, el proceso conserva
+ * su memoria y su tamaño.
+ * @param process El proceso, que debe tener memoria asignada.
+ * @param size El nuevo tamaño del proceso.
+ * @return La forma en que se cambio el tamaño.
+ * */
+enum ReallocPath reallocate_memory(Process *process, long size) {
+    int index = hash_get(memory->owners, process->pid);
+    long old_process_size = process->size;
+    enum ReallocPath path;
+
+    if (index == NOT_FOUND || size <= 0 || size > memory->total_size) {
+        path = REALLOC_FAILED;
+    } else if (memory->model == BITMAP_MODEL) {
+        path = reallocate_bits(index, size);
+    } else if (size <= process->size) {
+        shrink_block(index, size);
+        path = REALLOC_SHRUNK;
+    } else if (grow_block(index, size)) {
+        path = REALLOC_GREW;
+    } else {
+        char *fit = current_fit();
+        long old_size = process->size;
+
+        // El bloque nuevo se busca antes de liberar el actual para no perderlo si falla.
+        process->size = size;
+        int block_index = fit_block(process, fit);
+        if (block_index == NO_BLOCK) {
+            process->size = old_size;
+            path = REALLOC_FAILED;
+        } else {
+            if (memory->backing != NULL) {
+                move_region(memory->backing, block_at(memory->blocks, index)->base,
+                            block_at(memory->blocks, block_index)->base, old_size);
+            }
+            memory->relocated_units += old_size;
+            memory->relocated_blocks++;
+            release_block(index);
+            path = REALLOC_MOVED;
+        }
+    }
+
+    if (path != REALLOC_FAILED) {
+        // Lo que crecio recibe el resto del patron del proceso.
+        if (memory->backing != NULL && size > old_process_size) {
+            fill_region(memory->backing, process, base_of(process), old_process_size, size);
+        }
+        process->size = size;
+    }
+    memory->reallocations[path]++;
+    return path;
+}
+
+/**
+ * Esta funcion cambia el tamaño de la memoria de un proceso e imprime la forma
+ * en que se hizo.
+ * @param process El proceso.
+ * @param size El nuevo tamaño del proceso.
+ * */
+void resize_memory(Process *process, long size) {
+    if (size <= 0) {
+        printf("Invalid process size\n");
+        return;
+    }
+    if (size > memory->total_size) {
+        printf("Process %d is larger than the memory\n", process->pid);
+        return;
+    }
+    if (hash_get(memory->owners, process->pid) == NOT_FOUND) {
+        printf("Process %d has no memory assigned\n", process->pid);
+        return;
+    }
+
+    switch (reallocate_memory(process, size)) {
+        case REALLOC_SHRUNK:
+            printf("Process %d shrunk in place to %ld units\n", process->pid, size);
+            break;
+        case REALLOC_GREW:
+            printf("Process %d grown in place to %ld units\n", process->pid, size);
+            break;
+        case REALLOC_MOVED:
+            printf("Process %d moved to block at base %ld with %ld units\n", process->pid,
+                   memory->model == BITMAP_MODEL
+                   ? memory->allocations[hash_get(memory->owners, process->pid)].base
+                   : block_at(memory->blocks, hash_get(memory->owners, process->pid))->base,
+                   size);
+            break;
+        default:
+            printf("Process %d could not be resized to %ld units\n", process->pid, size);
+            break;
     }
 }
 
@@ -287,24 +1275,140 @@ void assign_memory(Process *process, char *fit) {
  * Se imprime una tabla con los bloques de memoria y su estado.
  * */
 void report_memory() {
-    char *columns[] = {"Block#", "Process ID",
-                       "Base", "Limit", "Available space", "Size"};
+    if (memory->model == BITMAP_MODEL) {
+        report_bitmap();
+        return;
+    }
 
-    printf("%8s %12s %7s %8s %18s %7s\n",
-           columns[0], columns[1], columns[2], columns[3], columns[4], columns[5]);
+    BlockTable *blocks = memory->blocks;
+    print_report_header();
 
-    for (int i = 0; i < memory->blocks->size; i++) {
-        MemoryBlock *block = get_at(memory->blocks, i);
+    int number = 1;
+    long internal_fragmentation = 0;
+    char pid[16];
+    for (int i = blocks->head; i != NO_BLOCK; i = blocks->slots[i].next, number++) {
+        MemoryBlock *block = &blocks->slots[i];
 
         if (block->process == NULL) {
-            printf("%3d %11s %11d %10d %8d %18d\n",
-                   i + 1, "Free", block->base, block->limit,
-                   block->remaining_size, block->size);
+            print_report_row(number, "Free", block->base, block->size, block->size);
             continue;
         }
 
-        printf("%3d %11d %11d %10d %8d %18d\n",
-               i + 1, block->process->pid, block->base, block->limit,
-               block->remaining_size, block->size);
+        snprintf(pid, sizeof(pid), "%d", block->process->pid);
+        print_report_row(number, pid, block->base, block->size, get_remaining_memory_from(i));
+        internal_fragmentation += get_remaining_memory_from(i);
+    }
+
+    // El espacio sobrante dentro de los bloques asignados (sistema buddy).
+    printf("Internal fragmentation: %ld of %ld units\n",
+           internal_fragmentation, memory->total_size);
+
+    printf("Relocation cost: %ld units in %ld blocks\n",
+           memory->relocated_units, memory->relocated_blocks);
+
+    // Promedio de bloques visitados por las busquedas lineales.
+    ScanStats first = memory->first_fit_stats, next = memory->next_fit_stats;
+    printf("Blocks scanned per allocation: ff %.2f (%ld), nf %.2f (%ld)\n",
+           first.searches > 0 ? (double) first.scanned / (double) first.searches : 0.0,
+           first.searches,
+           next.searches > 0 ? (double) next.scanned / (double) next.searches : 0.0,
+           next.searches);
+}
+
+/**
+ * Cuenta los huecos del modelo de mapa de bits recorriendo el mapa de 64 en 64 bits.
+ * @param classes Donde se cuentan los huecos por clase de tamaño; puede ser NULL.
+ * @param count Donde se guarda el numero de huecos; puede ser NULL.
+ * @return El tamaño del mayor hueco.
+ * */
+static long scan_bitmap_gaps(int *classes, int *count) {
+    Bitmap *bitmap = memory->bitmap;
+    long largest = 0;
+    int gaps = 0;
+
+    for (long start = bitmap_next_clear(bitmap, 0); start < bitmap->size;) {
+        long end = bitmap_next_set(bitmap, start);
+        long size = (end - start) * memory->unit_size;
+        largest = size > largest ? size : largest;
+        gaps++;
+        if (classes != NULL) {
+            classes[63 - __builtin_clzl((unsigned long) size)]++;
+        }
+        start = bitmap_next_clear(bitmap, end);
+    }
+    if (count != NULL) {
+        *count = gaps;
+    }
+    return largest;
+}
+
+/**
+ * Obtiene el tamaño del mayor bloque libre usando el indice de bloques libres
+ * de la forma de administracion actual, sin recorrer la tabla.
+ * */
+static long largest_free_block() {
+    if (memory->model == BITMAP_MODEL) {
+        return scan_bitmap_gaps(NULL, NULL);
+    }
+    if (memory->mode == BUDDY_MODE) {
+        return buddy_largest();
+    }
+    if (memory->mode == TLSF_MODE) {
+        return tlsf_largest();
+    }
+    TreeNode *last = tree_last(memory->free_blocks);
+    return last != NULL ? last->key : 0;
+}
+
+/**
+ * Obtiene la fragmentacion externa: la fraccion de la memoria libre que no
+ * esta en el mayor bloque libre. Es O(1) en el modelo de bloques (en TLSF el mayor
+ * bloque es una cota); en el modelo de mapa de bits recorre el mapa.
+ * @return Un valor entre 0 (toda la memoria libre es contigua) y 1.
+ * */
+double external_fragmentation() {
+    long free_size = memory->remaining_size;
+    return free_size > 0 ? 1.0 - (double) largest_free_block() / (double) free_size : 0.0;
+}
+
+/**
+ * Reporta las metricas de fragmentacion del modelo de bloques en O(1):
+ * todas se mantienen al agregar y remover bloques del indice de bloques libres.
+ * En el modelo de mapa de bits los huecos no se guardan, asi que se cuentan
+ * recorriendo el mapa de 64 en 64 bits.
+ * */
+void report_summary() {
+    long free_size = memory->remaining_size, largest;
+    int free_count, *classes, bitmap_classes[SIZE_CLASSES] = {0};
+
+    if (memory->model == BITMAP_MODEL) {
+        largest = scan_bitmap_gaps(bitmap_classes, &free_count);
+        classes = bitmap_classes;
+    } else {
+        largest = largest_free_block();
+        free_count = memory->free_count;
+        classes = memory->free_classes;
+    }
+
+    printf("Free memory: %ld of %ld units (%.2f%%)\n", free_size, memory->total_size,
+           100.0 * (double) free_size / (double) memory->total_size);
+    printf("Allocated blocks: %d, free blocks: %d\n", memory->allocated_blocks, free_count);
+    // TLSF solo conoce la clase del mayor bloque, asi que se imprime su cota.
+    printf(memory->model == BLOCK_MODEL && memory->mode == TLSF_MODE
+           ? "Largest free block: at most %ld units\n" : "Largest free block: %ld units\n", largest);
+    // La fraccion de la memoria libre que no se puede usar para el proceso mas grande posible.
+    printf("External fragmentation: %.4f\n",
+           free_size > 0 ? 1.0 - (double) largest / (double) free_size : 0.0);
+    printf("Reallocations: %ld shrunk in place, %ld grown in place, %ld moved, %ld failed\n",
+           memory->reallocations[REALLOC_SHRUNK], memory->reallocations[REALLOC_GREW],
+           memory->reallocations[REALLOC_MOVED], memory->reallocations[REALLOC_FAILED]);
+    printf("Recent allocation failure rate: %.4f\n", memory->failure_rate);
+
+    printf("Free blocks by size:\n");
+    for (int i = 0; i < SIZE_CLASSES; i++) {
+        if (classes[i] > 0) {
+            printf("%20ld - %-20ld %d\n", 1L << i, i < 62 ? (1L << (i + 1)) - 1 : memory->total_size,
+                   classes[i]);
+        }
     }
-}
\ No newline at end of file
+}
@@ -6,37 +6,201 @@
 #define SHELL_MEMORY_H
 
 #include "Process.h"
-#include "List.h"
+#include "Table.h"
+#include "Tree.h"
+#include "Bitmap.h"
+#include "Hash.h"
+#include "Backing.h"
 
-#define MAX_SIZE 1024
+// Tamaño de la memoria si no se indica otro.
+#define DEFAULT_MEMORY_SIZE 1024L
 
+// Tamaño maximo de la memoria; deja margen para redondear tamaños sin desbordar.
+#define MAX_MEMORY_SIZE (1L << 62)
+
+// Numero maximo de bits del modelo de mapa de bits; con memorias mayores
+// cada bit representa varias unidades.
+#define BITMAP_MAX_BITS (1L << 24)
+
+// Numero de ordenes posibles para el sistema buddy (bloques de 2^0 a 2^63).
+#define BUDDY_ORDERS 64
+
+// Clases de tamaño del histograma de bloques libres (potencias de dos).
+#define SIZE_CLASSES 64
+
+// La tasa de fallos reciente pesa cada asignacion como 1/FAILURE_RATE_WINDOW.
+#define FAILURE_RATE_WINDOW 32
+
+// Clases de tamaño de TLSF: cada potencia de dos se divide en 2^TLSF_SL_BITS listas.
+#define TLSF_SL_BITS 4
+#define TLSF_SL (1 << TLSF_SL_BITS)
+#define TLSF_FL (64 - TLSF_SL_BITS + 1)
+
+/**
+ * Forma en que se administran los bloques de la memoria.
+ * PARTITION_MODE: particiones de tamaño variable (ff, nf, bf, wf).
+ * BUDDY_MODE: bloques de potencias de dos (buddy).
+ * TLSF_MODE: particiones de tamaño variable en listas segregadas (tlsf).
+ * */
+enum MemoryMode {
+    PARTITION_MODE, BUDDY_MODE, TLSF_MODE
+};
+
+/**
+ * Forma en que se representa la memoria.
+ * BLOCK_MODEL: una tabla de bloques en orden de direccion.
+ * BITMAP_MODEL: un mapa de bits con un bit por cada unit_size unidades de memoria.
+ * */
+enum MemoryModel {
+    BLOCK_MODEL, BITMAP_MODEL
+};
+
+/**
+ * Estructura que representa la memoria asignada a un proceso en el modelo de mapa de bits.
+ * @param base La direccion donde inicia la memoria asignada.
+ * @param size El numero de unidades asignadas, redondeado a unit_size.
+ * @param process El proceso al que pertenece.
+ * */
 typedef struct {
-    int size;
-    int remaining_size;
-    int base;
-    int limit;
+    long base;
+    long size;
     Process *process;
-} MemoryBlock;
+} Allocation;
+
+/**
+ * Hacia donde se mueven los bloques asignados al compactar.
+ * COMPACT_TO_BASE: todos hacia la direccion 0.
+ * COMPACT_MIN_MOVES: los primeros hacia la direccion 0 y los demas hacia el final,
+ * eligiendo la division que mueve menos unidades.
+ * */
+enum CompactionPolicy {
+    COMPACT_TO_BASE, COMPACT_MIN_MOVES
+};
+
+/**
+ * Forma en que se cambio el tamaño de la memoria de un proceso.
+ * REALLOC_FAILED: no se pudo cambiar; el proceso conserva su memoria.
+ * REALLOC_SHRUNK: se redujo en su lugar y el sobrante quedo libre.
+ * REALLOC_GREW: crecio en su lugar tomando memoria libre del bloque siguiente.
+ * REALLOC_MOVED: se movio a otro bloque con el algoritmo de asignacion actual.
+ * */
+enum ReallocPath {
+    REALLOC_FAILED, REALLOC_SHRUNK, REALLOC_GREW, REALLOC_MOVED
+};
+
+// Numero de formas de cambiar el tamaño de la memoria de un proceso.
+#define REALLOC_PATHS 4
+
+/**
+ * Estadisticas de las busquedas lineales de un algoritmo de asignacion.
+ * @param searches El numero de busquedas realizadas.
+ * @param scanned El numero total de bloques visitados.
+ * */
+typedef struct {
+    long searches;
+    long scanned;
+} ScanStats;
 
+/**
+ * Estructura que representa la memoria simulada.
+ * @param total_size El tamaño de la memoria.
+ * @param remaining_size La memoria sin asignar: la suma de los bloques libres.
+ * @param model La forma en que se representa la memoria.
+ * @param blocks La tabla de bloques en orden de direccion (BLOCK_MODEL).
+ * @param free_blocks Los bloques libres ordenados por tamaño (PARTITION_MODE).
+ * @param mode La forma en que se administran los bloques.
+ * @param allocated_blocks El numero de bloques con un proceso asignado.
+ * @param buddy_lists El primer bloque libre de cada orden (BUDDY_MODE).
+ * @param buddy_orders Mapa de bits de los ordenes con bloques libres (BUDDY_MODE).
+ * @param tlsf_first Mapa de bits de las clases de primer nivel con bloques libres (TLSF_MODE).
+ * @param tlsf_second Mapa de bits de las listas con bloques libres de cada clase (TLSF_MODE).
+ * @param tlsf_lists El primer bloque libre de cada lista segregada (TLSF_MODE).
+ * @param cursor El bloque donde inicia la siguiente busqueda de next fit.
+ * @param first_fit_stats Los bloques visitados por first fit.
+ * @param next_fit_stats Los bloques visitados por next fit.
+ * @param relocated_units El total de unidades movidas por compactaciones.
+ * @param relocated_blocks El total de bloques movidos por compactaciones.
+ * @param bitmap Las unidades ocupadas de la memoria (BITMAP_MODEL).
+ * @param unit_size El numero de unidades que representa cada bit (BITMAP_MODEL).
+ * @param allocations La memoria asignada a cada proceso; hay allocated_blocks (BITMAP_MODEL).
+ * @param allocations_capacity El numero de asignaciones que caben en allocations.
+ * @param free_count El numero de bloques libres (BLOCK_MODEL).
+ * @param free_classes El numero de bloques libres de cada tamaño: la clase k
+ * tiene los bloques de 2^k a 2^(k+1) - 1 unidades (BLOCK_MODEL).
+ * @param owners El indice del bloque (BLOCK_MODEL) o de la asignacion (BITMAP_MODEL)
+ * de cada proceso con memoria asignada, por pid.
+ * @param partition_fit El ultimo algoritmo de particiones usado (ff, nf, bf o wf);
+ * con el se mueven los procesos que no pueden crecer en su lugar.
+ * @param reallocations El numero de cambios de tamaño por cada forma en que se hicieron.
+ * @param generation Cambia cada vez que cambia algun bloque o asignacion; sirve para
+ * saber si un indice construido antes sigue al dia.
+ * @param failure_rate La fraccion de las asignaciones recientes que no encontraron
+ * espacio, como promedio movil exponencial.
+ * @param failed_size El tamaño de la ultima asignacion que no encontro espacio.
+ * @param backing Los bytes reales de la memoria, NULL si solo se simulan los bloques.
+ * */
 typedef struct {
-    int total_size;
-    int remaining_size;
-    List *blocks;
+    long total_size;
+    long remaining_size;
+    enum MemoryModel model;
+    BlockTable *blocks;
+    Tree *free_blocks;
+    enum MemoryMode mode;
+    int allocated_blocks;
+    int buddy_lists[BUDDY_ORDERS];
+    unsigned long buddy_orders;
+    unsigned long tlsf_first;
+    unsigned int tlsf_second[TLSF_FL];
+    int tlsf_lists[TLSF_FL][TLSF_SL];
+    int cursor;
+    ScanStats first_fit_stats;
+    ScanStats next_fit_stats;
+    long relocated_units;
+    long relocated_blocks;
+    Bitmap *bitmap;
+    long unit_size;
+    Allocation *allocations;
+    int allocations_capacity;
+    int free_count;
+    int free_classes[SIZE_CLASSES];
+    HashMap *owners;
+    char partition_fit[3];
+    long reallocations[REALLOC_PATHS];
+    long generation;
+    double failure_rate;
+    long failed_size;
+    Backing *backing;
 } Memory;
 
-static Memory *memory;
+// Cada hilo tiene su propia memoria actual; los hilos del modo concurrente usan la de su arena.
+extern _Thread_local Memory *memory;
 
-void init_memory();
-int get_limit_from(int block_index);
-int get_size_from(int block_index);
-int get_remaining_memory_from(int block_index);
-void make_memory_block(int block_index, int base, int limit);
+void init_memory(enum MemoryModel model, long size);
+void release_memory();
+void empty_memory(enum MemoryMode mode);
+long bitmap_unit_size(long size);
+long get_limit_from(int block_index);
+long get_size_from(int block_index);
+long get_remaining_memory_from(int block_index);
+int make_memory_block(int previous_index, long base, long size);
+void index_free_block(int block_index);
+void unindex_free_block(int block_index);
 bool assign_to_block(int block_index, Process *process);
+int coalesce_block(int block_index);
 bool free_memory(int pid);
-void compact_memory();
-void best_fit(Process *process);
-void worst_fit(Process *process);
-void first_fit(Process *process);
+void compact_memory(enum CompactionPolicy policy);
+int best_fit(Process *process);
+int worst_fit(Process *process);
+int first_fit(Process *process);
+int next_fit(Process *process);
+bool select_fit(char *fit);
+long allocate_memory(Process *process, char *fit);
+char *current_fit();
+long base_of(Process *process);
 void report_memory();
+void report_summary();
+double external_fragmentation();
 void assign_memory(Process *process, char *fit);
+enum ReallocPath reallocate_memory(Process *process, long size);
+void resize_memory(Process *process, long size);
 #endif //SHELL_MEMORY_H
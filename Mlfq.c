@@ -0,0 +1,170 @@
+//
+// Created by yaelao on 6/21/23.
+//
+
+#include "Mlfq.h"
+
+// La configuracion de las siguientes planificaciones.
+static MlfqConfig mlfq_config = {3, {4, 8, 16}, 100};
+
+/**
+ * Crea las colas de los niveles con la configuracion actual.
+ * */
+static void *create_mlfq(Scheduler *scheduler) {
+    Mlfq *mlfq = (Mlfq *) calloc(1, sizeof(Mlfq));
+    mlfq->config = mlfq_config;
+    for (int level = 0; level < mlfq->config.num_levels; level++) {
+        mlfq->levels[level] = create_ring(64);
+    }
+    return mlfq;
+}
+
+/**
+ * Libera las colas de los niveles.
+ * */
+static void destroy_mlfq(void *ready) {
+    Mlfq *mlfq = (Mlfq *) ready;
+    for (int level = 0; level < mlfq->config.num_levels; level++) {
+        clear_ring(mlfq->levels[level]);
+    }
+    free(mlfq);
+}
+
+/**
+ * Agrega un trabajo al final de la cola de su nivel. Un trabajo que llega entra
+ * al nivel mas alto y uno que agoto su quantum baja un nivel.
+ * */
+static void mlfq_enqueue(Scheduler *scheduler, Job *job, enum ReadyReason reason) {
+    Mlfq *mlfq = (Mlfq *) scheduler->ready;
+    if (reason == ARRIVED) {
+        job->level = 0;
+    } else if (reason == EXPIRED && job->level < mlfq->config.num_levels - 1) {
+        job->level++;
+    }
+    ring_push(mlfq->levels[job->level], job);
+    mlfq->non_empty |= 1U << job->level;
+}
+
+/**
+ * Obtiene el nivel mas alto con trabajos.
+ * @return El nivel, -1 si no hay trabajos.
+ * */
+static inline int highest_level(Mlfq *mlfq) {
+    return mlfq->non_empty != 0 ? __builtin_ctz(mlfq->non_empty) : -1;
+}
+
+/**
+ * Remueve el primer trabajo del nivel mas alto con trabajos.
+ * */
+static Job *mlfq_pick(Scheduler *scheduler) {
+    Mlfq *mlfq = (Mlfq *) scheduler->ready;
+    int level = highest_level(mlfq);
+    if (level < 0) {
+        return NULL;
+    }
+    Job *job = (Job *) ring_pop(mlfq->levels[level]);
+    if (is_ring_empty(mlfq->levels[level])) {
+        mlfq->non_empty &= ~(1U << level);
+    }
+    return job;
+}
+
+/**
+ * Obtiene el primer trabajo del nivel mas alto con trabajos.
+ * */
+static Job *mlfq_peek(Scheduler *scheduler) {
+    Mlfq *mlfq = (Mlfq *) scheduler->ready;
+    int level = highest_level(mlfq);
+    return level < 0 ? NULL : (Job *) ring_front(mlfq->levels[level]);
+}
+
+/**
+ * Deja un trabajo en el CPU por el quantum de su nivel.
+ * */
+static long level_quantum(Scheduler *scheduler, Job *job) {
+    return ((Mlfq *) scheduler->ready)->config.quanta[job->level];
+}
+
+/**
+ * Un trabajo que llega entra al nivel mas alto, asi que saca del CPU a
+ * cualquier trabajo de un nivel mas bajo.
+ * */
+static bool higher_level(Scheduler *scheduler, Job *running, Job *arrived) {
+    return arrived->level < running->level;
+}
+
+/**
+ * Obtiene cada cuanto los trabajos regresan al nivel mas alto.
+ * */
+static long boost_period(Scheduler *scheduler) {
+    return ((Mlfq *) scheduler->ready)->config.boost_period;
+}
+
+/**
+ * Regresa todos los trabajos al nivel mas alto, en orden de nivel, para que los
+ * trabajos largos que bajaron no se queden sin CPU.
+ * */
+static void boost(Scheduler *scheduler) {
+    Mlfq *mlfq = (Mlfq *) scheduler->ready;
+    Ring *top = mlfq->levels[0];
+    for (int level = 1; level < mlfq->config.num_levels; level++) {
+        Job *job;
+        while ((job = (Job *) ring_pop(mlfq->levels[level])) != NULL) {
+            job->level = 0;
+            ring_push(top, job);
+        }
+    }
+    mlfq->non_empty = is_ring_empty(top) ? 0 : 1U;
+    if (scheduler->running != NULL) {
+        scheduler->running->level = 0;
+    }
+    if (scheduler->trace) {
+        printf("%ld\t\t-\t\tboost\n", scheduler->now);
+    }
+}
+
+SchedulerPolicy mlfq_policy = {
+        .name = "mlfq", .create = create_mlfq, .destroy = destroy_mlfq, .enqueue = mlfq_enqueue,
+        .pick = mlfq_pick, .peek = mlfq_peek, .slice = level_quantum, .preempts = higher_level,
+        .period = boost_period, .tick = boost
+};
+
+/**
+ * Esta funcion cambia la configuracion de las siguientes planificaciones con la
+ * cola multinivel.
+ * @param boost_period Cada cuanto todos los trabajos regresan al nivel mas alto, 0 si nunca.
+ * @param quanta El quantum de cada nivel, del mas alto al mas bajo.
+ * @param num_levels El numero de niveles.
+ * @return true si la configuracion es valida, false en caso contrario.
+ * */
+bool configure_mlfq(long boost_period, long *quanta, int num_levels) {
+    if (boost_period < 0 || num_levels < 1 || num_levels > MLFQ_MAX_LEVELS) {
+        return false;
+    }
+    for (int level = 0; level < num_levels; level++) {
+        if (quanta[level] <= 0) {
+            return false;
+        }
+    }
+    mlfq_config.num_levels = num_levels;
+    mlfq_config.boost_period = boost_period;
+    for (int level = 0; level < num_levels; level++) {
+        mlfq_config.quanta[level] = quanta[level];
+    }
+    return true;
+}
+
+/**
+ * Esta funcion imprime la configuracion de la cola multinivel.
+ * */
+void print_mlfq() {
+    printf("MLFQ: %d levels with quanta", mlfq_config.num_levels);
+    for (int level = 0; level < mlfq_config.num_levels; level++) {
+        printf("%s %ld", level == 0 ? "" : ",", mlfq_config.quanta[level]);
+    }
+    if (mlfq_config.boost_period > 0) {
+        printf(" ms, boost every %ld ms\n", mlfq_config.boost_period);
+    } else {
+        printf(" ms, no boost\n");
+    }
+}
@@ -0,0 +1,42 @@
+//
+// Created by yaelao on 6/21/23.
+//
+
+#ifndef SHELL_MLFQ_H
+#define SHELL_MLFQ_H
+
+#include <stdint.h>
+#include "Scheduler.h"
+
+// El mayor numero de niveles; cada nivel es un bit del mapa de niveles con trabajos.
+#define MLFQ_MAX_LEVELS 32
+
+/**
+ * Estructura que representa la configuracion de la cola multinivel.
+ * @param num_levels El numero de niveles.
+ * @param quanta El quantum de cada nivel, del mas alto al mas bajo.
+ * @param boost_period Cada cuanto todos los trabajos regresan al nivel mas alto, 0 si nunca.
+ * */
+typedef struct {
+    int num_levels;
+    long quanta[MLFQ_MAX_LEVELS];
+    long boost_period;
+} MlfqConfig;
+
+/**
+ * Estructura que representa la cola de listos multinivel de una planificacion.
+ * @param config La configuracion con la que se creo.
+ * @param levels La cola de cada nivel.
+ * @param non_empty El bit i esta encendido si el nivel i tiene trabajos.
+ * */
+typedef struct {
+    MlfqConfig config;
+    Ring *levels[MLFQ_MAX_LEVELS];
+    uint32_t non_empty;
+} Mlfq;
+
+extern SchedulerPolicy mlfq_policy;
+
+bool configure_mlfq(long boost_period, long *quanta, int num_levels);
+void print_mlfq();
+#endif //SHELL_MLFQ_H
@@ -0,0 +1,425 @@
+//
+// Created by yaelao on 6/13/23.
+//
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Paging.h"
+
+Paging *paging;
+
+/**
+ * Libera la memoria paginada actual y las tablas de paginas de los procesos.
+ * */
+static void release_paging() {
+    for (int i = 0; i < paging->num_tables; i++) {
+        PageTable *table = &paging->tables[i];
+        for (long j = 0; j < table->num_leaves; j++) {
+            free(table->leaves[j]);
+        }
+        free(table->leaves);
+    }
+    free(paging->tables);
+    clear_hash(paging->table_of);
+    free(paging->frames);
+    free(paging);
+    paging = NULL;
+}
+
+/**
+ * Esta funcion divide la memoria en marcos del tamaño indicado para simular
+ * memoria virtual paginada. Si ya existia una memoria paginada, se reemplaza.
+ * @param policy La politica de reemplazo de paginas.
+ * @param frame_size El tamaño de cada marco.
+ * @return true si se creo la memoria paginada, false si el numero de marcos no es valido.
+ * */
+bool init_paging(enum ReplacementPolicy policy, long frame_size) {
+    long num_frames = frame_size > 0 ? memory->total_size / frame_size : 0;
+    if (num_frames < 1 || num_frames > MAX_FRAMES) {
+        return false;
+    }
+    if (paging != NULL) {
+        release_paging();
+    }
+
+    paging = (Paging *) malloc(sizeof(Paging));
+    paging->frame_size = frame_size;
+    paging->num_frames = (int) num_frames;
+    paging->used_frames = 0;
+    paging->frames = (Frame *) malloc(num_frames * sizeof(Frame));
+    paging->policy = policy;
+    paging->hand = 0;
+    paging->lru_head = NO_FRAME;
+    paging->lru_tail = NO_FRAME;
+    for (int i = 0; i < AGE_VALUES; i++) {
+        paging->age_lists[i] = NO_FRAME;
+    }
+    memset(paging->age_map, 0, sizeof(paging->age_map));
+    paging->tables_capacity = 16;
+    paging->tables = (PageTable *) malloc(paging->tables_capacity * sizeof(PageTable));
+    paging->num_tables = 0;
+    paging->table_of = create_hash(16);
+    paging->references = 0;
+    paging->faults = 0;
+    paging->evictions = 0;
+    return true;
+}
+
+/**
+ * Obtiene el nombre de una politica de reemplazo.
+ * */
+char *policy_name(enum ReplacementPolicy policy) {
+    switch (policy) {
+        case LRU_POLICY:
+            return "lru";
+        case CLOCK_POLICY:
+            return "clock";
+        case AGING_POLICY:
+            return "aging";
+        default:
+            return "fifo";
+    }
+}
+
+/**
+ * Obtiene la tabla de paginas de un proceso, creandola si no existe.
+ * */
+static PageTable *table_for(int pid) {
+    int index = hash_get(paging->table_of, pid);
+    if (index != NOT_FOUND) {
+        return &paging->tables[index];
+    }
+
+    if (paging->num_tables == paging->tables_capacity) {
+        paging->tables_capacity *= 2;
+        paging->tables = (PageTable *) realloc(paging->tables,
+                                               paging->tables_capacity * sizeof(PageTable));
+    }
+    hash_put(paging->table_of, pid, paging->num_tables);
+    PageTable *table = &paging->tables[paging->num_tables++];
+    table->pid = pid;
+    table->leaves = NULL;
+    table->num_leaves = 0;
+    return table;
+}
+
+/**
+ * Obtiene la entrada de una pagina en la tabla de paginas,
+ * creando la hoja que la contiene si no existe.
+ * @return La entrada; contiene el marco de la pagina o NO_FRAME.
+ * */
+static int *entry_for(PageTable *table, long page) {
+    long leaf = page >> PAGE_LEAF_BITS;
+
+    if (leaf >= table->num_leaves) {
+        long num_leaves = table->num_leaves > 0 ? table->num_leaves : 1;
+        while (num_leaves <= leaf) {
+            num_leaves *= 2;
+        }
+        table->leaves = (int **) realloc(table->leaves, num_leaves * sizeof(int *));
+        for (long i = table->num_leaves; i < num_leaves; i++) {
+            table->leaves[i] = NULL;
+        }
+        table->num_leaves = num_leaves;
+    }
+    if (table->leaves[leaf] == NULL) {
+        // Todos los bytes en 0xFF hacen que cada entrada valga NO_FRAME.
+        table->leaves[leaf] = (int *) malloc(PAGE_LEAF_SIZE * sizeof(int));
+        memset(table->leaves[leaf], 0xFF, PAGE_LEAF_SIZE * sizeof(int));
+    }
+    return &table->leaves[leaf][page & (PAGE_LEAF_SIZE - 1)];
+}
+
+/**
+ * Quita un marco de la lista de marcos en orden de uso en O(1).
+ * */
+static void lru_unlink(int frame) {
+    Frame *frames = paging->frames;
+    if (frames[frame].previous != NO_FRAME) {
+        frames[frames[frame].previous].next = frames[frame].next;
+    } else {
+        paging->lru_head = frames[frame].next;
+    }
+    if (frames[frame].next != NO_FRAME) {
+        frames[frames[frame].next].previous = frames[frame].previous;
+    } else {
+        paging->lru_tail = frames[frame].previous;
+    }
+}
+
+/**
+ * Agrega un marco al final de la lista de marcos en orden de uso en O(1),
+ * como el usado mas recientemente.
+ * */
+static void lru_append(int frame) {
+    Frame *frames = paging->frames;
+    frames[frame].previous = paging->lru_tail;
+    frames[frame].next = NO_FRAME;
+    if (paging->lru_tail != NO_FRAME) {
+        frames[paging->lru_tail].next = frame;
+    } else {
+        paging->lru_head = frame;
+    }
+    paging->lru_tail = frame;
+}
+
+/**
+ * Agrega un marco a la lista de los marcos con su misma edad en O(1).
+ * */
+static void age_push(int frame) {
+    Frame *frames = paging->frames;
+    int age = frames[frame].age;
+    int head = paging->age_lists[age];
+
+    frames[frame].previous = NO_FRAME;
+    frames[frame].next = head;
+    if (head != NO_FRAME) {
+        frames[head].previous = frame;
+    }
+    paging->age_lists[age] = frame;
+    paging->age_map[age / 64] |= 1UL << (age % 64);
+}
+
+/**
+ * Quita un marco de la lista de los marcos con su misma edad en O(1).
+ * */
+static void age_unlink(int frame) {
+    Frame *frames = paging->frames;
+    int age = frames[frame].age;
+
+    if (frames[frame].previous != NO_FRAME) {
+        frames[frames[frame].previous].next = frames[frame].next;
+    } else {
+        paging->age_lists[age] = frames[frame].next;
+    }
+    if (frames[frame].next != NO_FRAME) {
+        frames[frames[frame].next].previous = frames[frame].previous;
+    }
+    if (paging->age_lists[age] == NO_FRAME) {
+        paging->age_map[age / 64] &= ~(1UL << (age % 64));
+    }
+}
+
+/**
+ * Desplaza los contadores de envejecimiento: cada contador se recorre un bit
+ * a la derecha y el bit de referencia entra como el bit mas significativo.
+ * Las listas por edad se reconstruyen con los nuevos valores.
+ * */
+static void age_frames() {
+    for (int i = 0; i < AGE_VALUES; i++) {
+        paging->age_lists[i] = NO_FRAME;
+    }
+    memset(paging->age_map, 0, sizeof(paging->age_map));
+
+    for (int i = 0; i < paging->used_frames; i++) {
+        Frame *frame = &paging->frames[i];
+        frame->age = (uint8_t) ((frame->age >> 1) | (frame->referenced ? 0x80 : 0));
+        frame->referenced = false;
+        age_push(i);
+    }
+}
+
+/**
+ * Elige el marco cuya pagina sale de la memoria segun la politica de reemplazo.
+ * Todas cuestan O(1) (Clock amortizado): aging toma un marco de la menor edad
+ * con marcos usando el mapa de bits de edades.
+ * @return El indice del marco elegido.
+ * */
+static int choose_victim() {
+    int victim;
+
+    switch (paging->policy) {
+        case LRU_POLICY:
+            return paging->lru_head;
+        case AGING_POLICY:
+            for (int i = 0; i < AGE_VALUES / 64; i++) {
+                if (paging->age_map[i] != 0) {
+                    return paging->age_lists[i * 64 + __builtin_ctzl(paging->age_map[i])];
+                }
+            }
+            return NO_FRAME;
+        case CLOCK_POLICY:
+            // Las paginas usadas desde la ultima vuelta tienen una segunda oportunidad.
+            while (paging->frames[paging->hand].referenced) {
+                paging->frames[paging->hand].referenced = false;
+                paging->hand = (paging->hand + 1) % paging->num_frames;
+            }
+            break;
+        default:
+            // Cada pagina nueva reemplaza a la del marco elegido, asi que los marcos
+            // en orden circular estan en orden de carga.
+            break;
+    }
+    victim = paging->hand;
+    paging->hand = (paging->hand + 1) % paging->num_frames;
+    return victim;
+}
+
+/**
+ * Esta funcion simula una referencia a una pagina de un proceso. Si la pagina
+ * no esta en un marco ocurre un fallo de pagina: se carga en un marco libre o
+ * en el marco que elige la politica de reemplazo.
+ * @param pid El identificador del proceso.
+ * @param page El numero de pagina.
+ * @return true si la pagina ya estaba en memoria, false si hubo un fallo de pagina.
+ * */
+bool reference_page(int pid, long page) {
+    int *entry = entry_for(table_for(pid), page);
+    int frame = *entry;
+
+    paging->references++;
+    // Los contadores de aging avanzan una vez por cada num_frames referencias.
+    if (paging->policy == AGING_POLICY && paging->references % paging->num_frames == 0) {
+        age_frames();
+    }
+
+    if (frame != NO_FRAME) {
+        paging->frames[frame].referenced = true;
+        if (paging->policy == LRU_POLICY) {
+            lru_unlink(frame);
+            lru_append(frame);
+        }
+        return true;
+    }
+
+    paging->faults++;
+    if (paging->used_frames < paging->num_frames) {
+        frame = paging->used_frames++;
+    } else {
+        frame = choose_victim();
+        Frame *victim = &paging->frames[frame];
+        *entry_for(table_for(victim->pid), victim->page) = NO_FRAME;
+        if (paging->policy == LRU_POLICY) {
+            lru_unlink(frame);
+        } else if (paging->policy == AGING_POLICY) {
+            age_unlink(frame);
+        }
+        paging->evictions++;
+    }
+
+    paging->frames[frame] = (Frame) {
+            .pid = pid, .page = page, .referenced = true, .age = 0x80,
+            .previous = NO_FRAME, .next = NO_FRAME
+    };
+    if (paging->policy == LRU_POLICY) {
+        lru_append(frame);
+    } else if (paging->policy == AGING_POLICY) {
+        age_push(frame);
+    }
+    *entry = frame;
+    return false;
+}
+
+/**
+ * Lee un numero decimal o hexadecimal (con prefijo 0x) de un archivo mapeado.
+ * @param cursor La posicion actual; avanza hasta despues del numero.
+ * @param end El final del archivo.
+ * @param number Donde se guarda el numero.
+ * @return true si se leyo un numero, false si termino la linea.
+ * */
+bool read_number(char **cursor, char *end, unsigned long *number) {
+    char *position = *cursor;
+    while (position < end && (*position == ' ' || *position == '\t' || *position == ',')) {
+        position++;
+    }
+    if (position == end || *position == '\n' || *position == '\r' || *position == '#') {
+        *cursor = position;
+        return false;
+    }
+
+    unsigned long value = 0;
+    if (end - position > 2 && position[0] == '0' && (position[1] == 'x' || position[1] == 'X')) {
+        for (position += 2; position < end; position++) {
+            char digit = *position;
+            if (digit >= '0' && digit <= '9') value = value * 16 + (digit - '0');
+            else if (digit >= 'a' && digit <= 'f') value = value * 16 + (digit - 'a' + 10);
+            else if (digit >= 'A' && digit <= 'F') value = value * 16 + (digit - 'A' + 10);
+            else break;
+        }
+    } else {
+        for (; position < end && *position >= '0' && *position <= '9'; position++) {
+            value = value * 10 + (*position - '0');
+        }
+    }
+    *cursor = position;
+    *number = value;
+    return true;
+}
+
+/**
+ * Esta funcion reproduce un archivo de referencias a memoria. Cada linea tiene
+ * un pid y una direccion (decimal o hexadecimal); la pagina es la direccion
+ * entre el tamaño de marco. Las lineas vacias y las que inician con # se ignoran.
+ * El archivo se mapea a memoria y se recorre una sola vez.
+ * @param path La ruta del archivo.
+ * @return true si se reprodujo el archivo, false si no se pudo leer.
+ * */
+bool replay_page_trace(char *path) {
+    int fd = open(path, O_RDONLY);
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) < 0) {
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    if (status.st_size == 0) {
+        close(fd);
+        return true;
+    }
+    char *data = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    madvise(data, status.st_size, MADV_SEQUENTIAL);
+
+    char *cursor = data, *end = data + status.st_size;
+    long line = 0, skipped = 0;
+    while (cursor < end) {
+        unsigned long pid, address;
+        line++;
+        if (read_number(&cursor, end, &pid) && read_number(&cursor, end, &address)) {
+            unsigned long page = address / (unsigned long) paging->frame_size;
+            if (page < MAX_PAGES) {
+                reference_page((int) pid, (long) page);
+            } else {
+                skipped++;
+            }
+        }
+        // El resto de la linea se ignora.
+        while (cursor < end && *cursor++ != '\n');
+    }
+    munmap(data, status.st_size);
+
+    if (skipped > 0) {
+        printf("Skipped %ld references beyond %ld pages\n", skipped, MAX_PAGES);
+    }
+    return true;
+}
+
+/**
+ * Esta funcion reporta el estado de la memoria paginada: los marcos ocupados
+ * (solo si son pocos) y las estadisticas de fallos de pagina.
+ * */
+void report_paging() {
+    printf("Paging: %d frames of %ld units, %s replacement\n",
+           paging->num_frames, paging->frame_size, policy_name(paging->policy));
+
+    if (paging->num_frames <= 64) {
+        printf("%6s %11s %11s\n", "Frame#", "Process ID", "Page");
+        for (int i = 0; i < paging->num_frames; i++) {
+            if (i < paging->used_frames) {
+                printf("%6d %11d %11ld\n", i, paging->frames[i].pid, paging->frames[i].page);
+            } else {
+                printf("%6d %11s %11s\n", i, "Free", "-");
+            }
+        }
+    }
+
+    long hits = paging->references - paging->faults;
+    printf("References: %ld, page faults: %ld, evictions: %ld\n",
+           paging->references, paging->faults, paging->evictions);
+    printf("Hit rate: %.2f%%\n",
+           paging->references > 0 ? 100.0 * (double) hits / (double) paging->references : 0.0);
+}
@@ -0,0 +1,119 @@
+//
+// Created by yaelao on 6/13/23.
+//
+
+#ifndef SHELL_PAGING_H
+#define SHELL_PAGING_H
+
+#include <stdint.h>
+#include "Memory.h"
+#include "Hash.h"
+
+// Indice que representa la ausencia de un marco.
+#define NO_FRAME (-1)
+
+// Cada hoja de una tabla de paginas tiene 2^PAGE_LEAF_BITS entradas.
+#define PAGE_LEAF_BITS 10
+#define PAGE_LEAF_SIZE (1L << PAGE_LEAF_BITS)
+
+// Tamaño de marco si no se indica otro.
+#define DEFAULT_FRAME_SIZE 64L
+
+// Valores posibles del contador de envejecimiento.
+#define AGE_VALUES 256
+
+// Numero maximo de paginas por proceso y de marcos de la memoria.
+#define MAX_PAGES (1L << 32)
+#define MAX_FRAMES (1L << 24)
+
+/**
+ * Politica para elegir la pagina que sale cuando no hay marcos libres.
+ * FIFO_POLICY: la pagina que lleva mas tiempo cargada.
+ * LRU_POLICY: la pagina usada hace mas tiempo.
+ * CLOCK_POLICY: segunda oportunidad con un bit de referencia.
+ * AGING_POLICY: la pagina con el menor contador de envejecimiento (LRU aproximado).
+ * */
+enum ReplacementPolicy {
+    FIFO_POLICY, LRU_POLICY, CLOCK_POLICY, AGING_POLICY
+};
+
+/**
+ * Estructura que representa un marco de la memoria paginada.
+ * @param pid El proceso dueño de la pagina cargada.
+ * @param page La pagina cargada.
+ * @param previous El marco usado antes que este (LRU_POLICY) o el anterior con la misma edad (AGING_POLICY).
+ * @param next El marco usado despues que este (LRU_POLICY) o el siguiente con la misma edad (AGING_POLICY).
+ * @param referenced true si la pagina se uso desde la ultima revision (CLOCK_POLICY, AGING_POLICY).
+ * @param age El contador de envejecimiento de la pagina (AGING_POLICY).
+ * */
+typedef struct {
+    int pid;
+    long page;
+    int previous;
+    int next;
+    bool referenced;
+    uint8_t age;
+} Frame;
+
+/**
+ * Estructura que representa la tabla de paginas de dos niveles de un proceso.
+ * Las hojas se crean cuando se usa alguna de sus paginas.
+ * @param pid El proceso dueño de la tabla.
+ * @param leaves Las hojas de la tabla; cada entrada es el marco de una pagina o NO_FRAME.
+ * @param num_leaves El numero de hojas que caben en leaves.
+ * */
+typedef struct {
+    int pid;
+    int **leaves;
+    long num_leaves;
+} PageTable;
+
+/**
+ * Estructura que representa la memoria paginada.
+ * @param frame_size El tamaño de cada marco y de cada pagina.
+ * @param num_frames El numero de marcos en que se divide la memoria.
+ * @param used_frames El numero de marcos que ya tienen una pagina.
+ * @param frames Los marcos de la memoria.
+ * @param policy La politica de reemplazo.
+ * @param hand El siguiente marco a revisar (FIFO_POLICY, CLOCK_POLICY).
+ * @param lru_head El marco usado hace mas tiempo (LRU_POLICY).
+ * @param lru_tail El marco usado mas recientemente (LRU_POLICY).
+ * @param age_lists El primer marco con cada valor del contador de envejecimiento (AGING_POLICY).
+ * @param age_map Mapa de bits de los valores del contador con marcos (AGING_POLICY).
+ * @param tables Las tablas de paginas de los procesos.
+ * @param num_tables El numero de tablas de paginas.
+ * @param tables_capacity El numero de tablas que caben en tables.
+ * @param table_of El indice de la tabla de paginas de cada proceso, por pid.
+ * @param references El numero de referencias a paginas.
+ * @param faults El numero de fallos de pagina.
+ * @param evictions El numero de paginas reemplazadas.
+ * */
+typedef struct {
+    long frame_size;
+    int num_frames;
+    int used_frames;
+    Frame *frames;
+    enum ReplacementPolicy policy;
+    int hand;
+    int lru_head;
+    int lru_tail;
+    int age_lists[AGE_VALUES];
+    uint64_t age_map[AGE_VALUES / 64];
+    PageTable *tables;
+    int num_tables;
+    int tables_capacity;
+    HashMap *table_of;
+    long references;
+    long faults;
+    long evictions;
+} Paging;
+
+extern Paging *paging;
+
+bool init_paging(enum ReplacementPolicy policy, long frame_size);
+char *policy_name(enum ReplacementPolicy policy);
+bool reference_page(int pid, long page);
+bool read_number(char **cursor, char *end, unsigned long *number);
+bool replay_page_trace(char *path);
+void report_paging();
+#endif //SHELL_PAGING_H
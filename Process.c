@@ -4,6 +4,9 @@
 
 #include "Process.h"
 #include "Memory.h"
+#include "Scheduler.h"
+#include "Mlfq.h"
+#include "Cfs.h"
 
 /**
  * Esta funcion crea un proceso y lo agrega a la queue de procesos creados.
@@ -11,8 +14,10 @@
  * @param pid El id del proceso.
  * @param name El nombre del proceso.
  * @param burst_time El tiempo de rafaga del proceso.
+ * @param arrival_time El momento en que el proceso llega al planificador.
+ * @param nice El valor nice del proceso; entre menor, mas CPU recibe en el planificador justo.
  * */
-Process *make_process(int pid, int burst_time, int memory_blocks) {
+Process *make_process(int pid, int burst_time, long memory_blocks, int arrival_time, int nice) {
     Process *process = (Process *) malloc(sizeof(Process));
     process->pid = pid;
     process->burst_time = burst_time;
@@ -21,6 +26,9 @@ Process *make_process(int pid, int burst_time, int memory_blocks) {
     process->waiting_time = 0;
     process->turn_around_time = 0;
     process->t_time = 0;
+    process->arrival_time = arrival_time;
+    process->nice = nice;
+    process->vruntime = 0;
     return process;
 }
 
@@ -50,6 +58,8 @@ char *get_state(Process *process) {
             return "WAITING";
         case TERMINATED:
             return "TERMINATED";
+        case SWAPPED:
+            return "SWAPPED";
         default:
             return "UNKNOWN";
     }
@@ -62,9 +72,11 @@ char *get_state(Process *process) {
 void print_process(void *data) {
     Process *process = (Process *) data;
 
-    printf("PID: %d, Burst Time: %d, Memory Blocks: %d, State: %s\n",
+    printf("PID: %d, Burst Time: %d, Arrival: %d, Nice: %d, Memory Blocks: %ld, State: %s\n",
            process->pid,
            process->burst_time,
+           process->arrival_time,
+           process->nice,
            process->size,
            get_state(process)
     );
@@ -77,163 +89,54 @@ void print_process(void *data) {
  * @param queue La queue de procesos.
  * */
 void first_come_first_served(Queue *queue) {
-    Node *current = queue->head;
-    int current_time = 0, num_process = queue->size;
-    float total_wt = 0.0f, total_tat = 0.0f;
-
-    if (is_queue_empty(queue)) {
-        printf("Process queue is empty\n");
-        return;
-    }
-
-    while (current != NULL) {
-        Process *process = (Process *) current->data;
-        if (process->state == READY) {
-            // Se asigna el wt y el tat al proceso actual.
-            process->waiting_time = current_time;
-            process->turn_around_time = process->waiting_time + process->burst_time;
-
-            printf("Process [%d] enter to CPU, at: %d ms\n",
-                   process->pid, process->waiting_time);
-
-            current_time += process->burst_time;
-            total_wt += process->waiting_time;
-            total_tat += process->turn_around_time;
-
-            printf("Process [%d] exit from CPU, after %d ms\n\n",
-                   process->pid, process->burst_time);
-
-            // El proceso pasa de Ready a Terminated.
-            process->state = TERMINATED;
-            free_memory(process->pid);
-            current = (Node *) current->next;
-        }
-    }
-
-    printf("Average waiting time: %.2f\n",
-           total_wt / (float) num_process);
-    printf("Average turn around time: %.2f\n",
-           total_tat / (float) num_process);
+    schedule_queue(queue, &fcfs_policy, 0);
 }
 
 /**
- * Esta funcion obtiene el indice del proceso con el menor burst time.
+ * Esta funcion simula el algoritmo de planificacion de procesos
+ * Shortest Job First.
  * @param queue La queue de procesos.
- * @return El indice del proceso con el menor burst time.
  * */
-int get_shortest_index(Queue *queue) {
-    Node *current = queue->head;
-    int shortest_index = 0, index = 0;
-    int shortest_burst_time = ((Process *) current->data)->burst_time;
-
-    while (current != NULL) {
-        Process *process = (Process *) current->data;
-        if (process->burst_time < shortest_burst_time && process->state == READY) {
-            shortest_burst_time = process->burst_time;
-            shortest_index = index;
-        }
-        current = (Node *) current->next;
-        index++;
-    }
-
-    return shortest_index;
+void shortest_job_first(Queue *queue) {
+    schedule_queue(queue, &sjf_policy, 0);
 }
 
 /**
  * Esta funcion simula el algoritmo de planificacion de procesos
- * Shortest Job First.
+ * Shortest Remaining Time First: un proceso que llega saca del CPU al que esta
+ * en el si le falta menos tiempo.
  * @param queue La queue de procesos.
  * */
-void shortest_job_first(Queue *queue) {
-    if (is_queue_empty(queue)) {
-        printf("Process queue is empty\n");
-        return;
-    }
-
-    // se ordena la lista de procesos por burst time de menor a mayor.
-    sort_queue(queue, compare_process);
-    first_come_first_served(queue);
+void shortest_remaining_time_first(Queue *queue) {
+    schedule_queue(queue, &srtf_policy, 0);
 }
 
 /**
  * Esta funcion simula el algoritmo de planificacion de procesos
  * Round Robin.
  * @param queue La queue de procesos.
+ * @param quantum El tiempo que cada proceso puede estar en el CPU por turno.
  * */
 void round_robin(Queue *queue, int quantum) {
-    int current_time = 0, num_process = queue->size;
-    float total_wt = 0.0f, total_tat = 0.0f;
-    int ready_processes = 0, terminated_processes = 0;
-    Node *current = queue->head;
-
-    int remaining_burst[num_process], waiting_time[num_process],
-            turn_around_time[num_process], iteration[num_process];
-
-    if (is_queue_empty(queue)) {
-        printf("Process queue is empty\n");
-        return;
-    }
-
-    for (int i = 0; i < num_process; i++) {
-        Process *process = (Process *) current->data;
-        if (process->state == READY) {
-            ready_processes++;
-        }
-        remaining_burst[i] = process->burst_time;
-        waiting_time[i] = 0;
-        turn_around_time[i] = 0;
-        iteration[i] = 0;
-        current = (Node *) current->next;
-    }
-    printf("\nTa\t\tProcess\t\tState\t\tRemain\t\tW Time\t\tTaT\n");
-
-    do {
-        current = queue->head;
-        for (int i = 0; i < num_process; i++) {
-            Process *process = (Process *) current->data;
-            if (process->state == READY || process->state == WAITING) {
-                if (remaining_burst[i] > 0) {
-                    if (remaining_burst[i] > quantum) {
-                        waiting_time[i] += current_time - turn_around_time[i];
-                        printf("%d\t\tps %d\t\tenter\t\t%d/%d\t\t%d\t\t%d\n", current_time, process->pid,
-                               remaining_burst[i], process->burst_time, waiting_time[i], iteration[i]);
-                        process->state = RUNNING;
-                        current_time += quantum;
-                        remaining_burst[i] -= quantum;
-                        turn_around_time[i] = current_time;
-                        printf("%d\t\tps %d\t\texit\t\t%d/%d\t\t%d\t\t%d\n", current_time, process->pid,
-                               remaining_burst[i], process->burst_time, waiting_time[i], iteration[i]);
-                        process->state = WAITING;
-
-                    } else {
-                        waiting_time[i] += current_time - turn_around_time[i];
-                        printf("%d\t\tps %d\t\tenter\t\t%d/%d\t\t%d\t\t%d\n", current_time, process->pid,
-                               remaining_burst[i], process->burst_time, waiting_time[i], iteration[i]);
-                        current_time += remaining_burst[i];
-                        remaining_burst[i] = 0;
-                        iteration[i] = current_time;
-                        total_wt += waiting_time[i];
-                        total_tat += iteration[i];
-                        printf("%d\t\tps %d\t\texit\t\t%d/%d\t\t%d\t\t%d\n", current_time, process->pid,
-                               remaining_burst[i], process->burst_time, waiting_time[i], iteration[i]);
-                        process->state = TERMINATED;
-                        terminated_processes++;
-                        free_memory(process->pid);
-                    }
-                }
-
-            }
-            current = (Node *) current->next;
-        }
-    } while (ready_processes != terminated_processes);
+    schedule_queue(queue, &rr_policy, quantum);
+}
 
-    if (total_wt != 0) {
-        printf("Average waiting time: %.2f\n",
-               total_wt / (float) num_process);
-        printf("Average turn around time: %.2f\n",
-               total_tat / (float) num_process);
-    }
+/**
+ * Esta funcion simula el algoritmo de planificacion de procesos
+ * Multilevel Feedback Queue con la configuracion actual.
+ * @param queue La queue de procesos.
+ * */
+void multilevel_feedback_queue(Queue *queue) {
+    schedule_queue(queue, &mlfq_policy, 0);
+}
 
+/**
+ * Esta funcion simula un planificador completamente justo: el CPU se reparte en
+ * proporcion al peso de cada proceso, que depende de su valor nice.
+ * @param queue La queue de procesos.
+ * */
+void completely_fair_scheduler(Queue *queue) {
+    schedule_queue(queue, &cfs_policy, 0);
 }
 
 /**
@@ -7,8 +7,12 @@
 
 #include "Queue.h"
 
+// Los valores nice validos, como en Linux.
+#define MIN_NICE (-20)
+#define MAX_NICE 19
+
 enum ProcessState {
-    NEW, READY, WAITING, RUNNING, TERMINATED
+    NEW, READY, WAITING, RUNNING, TERMINATED, SWAPPED
 };
 
 typedef struct {
@@ -18,16 +22,21 @@ typedef struct {
     int waiting_time;
     int turn_around_time;
     int t_time;
-    int size;
+    int arrival_time;
+    int nice;
+    long vruntime;
+    long size;
 } Process;
 
-Process *make_process(int pid, int burst_time, int memory_blocks);
+Process *make_process(int pid, int burst_time, long memory_blocks, int arrival_time, int nice);
 int compare_process(void *data1, void *data2);
 void print_process(void *data);
 void first_come_first_served(Queue *queue);
 void shortest_job_first(Queue *queue);
-int get_shortest_index(Queue *queue);
+void shortest_remaining_time_first(Queue *queue);
 void round_robin(Queue *queue, int quantum);
+void multilevel_feedback_queue(Queue *queue);
+void completely_fair_scheduler(Queue *queue);
 Process *get_process(Queue *queue, int pid);
 void free_process(Process *process);
 void kill_process(Queue *queue, int pid);
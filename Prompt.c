@@ -20,9 +20,114 @@ enum Option value_of(char *key) {
 }
 
 
-void init_shell(void) {
+/**
+ * Esta funcion convierte un tamaño de memoria escrito por el usuario.
+ * Acepta los sufijos K, M, G y T (potencias de 1024).
+ * @param text El tamaño, por ejemplo 512, 64K o 2T.
+ * @return El tamaño en unidades, -1 si no es valido o excede MAX_MEMORY_SIZE.
+ * */
+long parse_size(char *text) {
+    char *end;
+    long size = strtol(text, &end, 10);
+    int shift = 0;
+
+    switch (*end) {
+        case 'K': case 'k': shift = 10; end++; break;
+        case 'M': case 'm': shift = 20; end++; break;
+        case 'G': case 'g': shift = 30; end++; break;
+        case 'T': case 't': shift = 40; end++; break;
+        default: break;
+    }
+    if (end == text || *end != '\0' || size <= 0 || size > MAX_MEMORY_SIZE >> shift) {
+        return -1;
+    }
+    return size << shift;
+}
+
+/**
+ * Esta funcion inicializa el shell.
+ * @param memory_size El tamaño de la memoria simulada.
+ * */
+void init_shell(long memory_size) {
     process_queue = create_queue();
-    init_memory();
+    init_memory(BLOCK_MODEL, memory_size);
+}
+
+/**
+ * Esta funcion convierte el nombre de una politica de reemplazo de paginas.
+ * @param name El nombre: fifo, lru, clock o aging.
+ * @param policy Donde se guarda la politica.
+ * @return true si el nombre es valido, false en caso contrario.
+ * */
+bool parse_policy(char *name, enum ReplacementPolicy *policy) {
+    enum ReplacementPolicy policies[] = {FIFO_POLICY, LRU_POLICY, CLOCK_POLICY, AGING_POLICY};
+    for (int i = 0; i < 4; i++) {
+        if (strcmp(name, policy_name(policies[i])) == 0) {
+            *policy = policies[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Esta funcion reproduce una cadena de referencias de un proceso, por ejemplo
+ * "ref 1 7 0 1 2 0 3" o "ref 1 7,0,1,2,0,3". Imprime cada pagina y marca con *
+ * las que causaron un fallo de pagina.
+ * @param pid El identificador del proceso.
+ * @param pages Las paginas, separadas por espacios o comas.
+ * */
+void replay_reference_string(int pid, char **pages) {
+    Process *process = get_process(process_queue, pid);
+    if (process == NULL) {
+        printf("Process not found\n");
+        return;
+    }
+
+    long num_pages = (process->size + paging->frame_size - 1) / paging->frame_size;
+    long references = 0, faults = 0;
+    for (int i = 0; pages[i] != NULL; i++) {
+        for (char *cursor = pages[i]; *cursor != '\0';) {
+            char *end;
+            long page = strtol(cursor, &end, 10);
+            if (end == cursor || page < 0 || page >= num_pages) {
+                printf("\nInvalid page, process %d has pages 0 to %ld\n", pid, num_pages - 1);
+                return;
+            }
+            bool hit = reference_page(pid, page);
+            printf("%ld%s ", page, hit ? "" : "*");
+            references++;
+            faults += !hit;
+            cursor = *end == ',' ? end + 1 : end;
+        }
+    }
+    printf("\nPage faults: %ld of %ld references (hit rate %.2f%%)\n", faults, references,
+           100.0 * (double) (references - faults) / (double) references);
+}
+
+/**
+ * Esta funcion reproduce un archivo de referencias e imprime cuantas
+ * referencias por segundo se simularon.
+ * @param path La ruta del archivo.
+ * */
+void replay_trace_file(char *path) {
+    long references = paging->references, faults = paging->faults;
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (!replay_page_trace(path)) {
+        printf("Could not read %s\n", path);
+        return;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (double) (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    references = paging->references - references;
+    faults = paging->faults - faults;
+    printf("Page faults: %ld of %ld references (hit rate %.2f%%)\n", faults, references,
+           references > 0 ? 100.0 * (double) (references - faults) / (double) references : 0.0);
+    printf("Replayed in %.3f s (%.0f references per second)\n", seconds,
+           seconds > 0 ? (double) references / seconds : 0.0);
 }
 
 /**
@@ -33,7 +138,8 @@ void init_shell(void) {
  * */
 
 char **split_args(char *args) {
-    char **args_array = malloc(100 * sizeof(char *));
+    // Cada argumento ocupa al menos un caracter y un espacio.
+    char **args_array = malloc((strlen(args) / 2 + 2) * sizeof(char *));
     char *arg = strtok(args, " ");
     int i = 0;
     while (arg != NULL) {
@@ -80,7 +186,8 @@ bool verify_num_of_args(char **args, int num_of_args) {
  * */
 
 char **split_args_execvp(char *args) {
-    char **args_array = malloc(100 * sizeof(char *));
+    // Cada argumento ocupa al menos un caracter y un espacio.
+    char **args_array = malloc((strlen(args) / 2 + 2) * sizeof(char *));
     char *arg = strtok(args, " ");
     int i = 0;
     args_array[i++] = arg;
@@ -109,11 +216,14 @@ char **split_args_execvp(char *args) {
  * los argumentos del comando.
  * */
 void exec_single_command(char **args) {
+    // Se vacia la salida para que el hijo no herede lo que esta en el buffer.
+    fflush(stdout);
     pid_t pid = fork();
     if (pid == 0) {
         if (execvp(args[0], args) == -1) {
             printf("Error executing command\n");
         }
+        exit(EXIT_FAILURE);
 
     } else {
         wait(NULL);
@@ -132,6 +242,7 @@ void exec_pipe(char **first_section, char **second_section) {
     pid_t first_section_pid, second_section_pid;
     int pipe_descriptor[2];
     pipe(pipe_descriptor);
+    fflush(stdout);
     /**
      * Se crea un nodo hijo para poder ejecutar
      * la primera seccion del pipe.
@@ -172,22 +283,27 @@ void exec_pipe(char **first_section, char **second_section) {
     }
 }
 /**
- * Esta funcion se encarga de leer la entrada del usuario.
- * @param input: String donde se guardara la entrada del usuario.
+ * Esta funcion se encarga de leer la entrada del usuario. La linea se lee
+ * completa con getline, sin importar su longitud.
+ * @param input: Donde se guardara la entrada del usuario, que se libera con free.
  * @return un booleano que indica si el usuario introdujo un pipe.
  * */
-bool read_user_input(char *input) {
-    bool has_pipe = false;
-    char char_input;
+bool read_user_input(char **input) {
+    size_t capacity = 0;
+    *input = NULL;
     printf("narco_barbie_69:~$ ");
-    while ((char_input = (char) getchar()) != '\n') {
-        if (char_input == '|') has_pipe = true;
-
-        strncat(input, &char_input, 1);
+    ssize_t length = getline(input, &capacity, stdin);
+    if (length < 0) {
+        // Al terminar la entrada estandar la linea queda vacia.
+        free(*input);
+        *input = calloc(1, sizeof(char));
+        return false;
+    }
+    if (length > 0 && (*input)[length - 1] == '\n') {
+        (*input)[length - 1] = '\0';
     }
-    strncat(input, "\0", 1);
 
-    return has_pipe;
+    return strchr(*input, '|') != NULL;
 }
 
 /**
@@ -197,7 +313,7 @@ bool read_user_input(char *input) {
  * @return un arreglo de strings con los canales separados.
  * */
 char **split_channels(char *input) {
-    char **channels = malloc(100 * sizeof(char *));
+    char **channels = malloc((strlen(input) + 1) * sizeof(char *));
     int i = 0;
     char *channel;
     while ((channel = strsep(&input, "|")) != NULL) {
@@ -228,9 +344,10 @@ void bash_commands(bool has_pipe, char *input) {
  * y de ejecutar los comandos introducidos por el usuario.
  * */
 void show_prompt() {
-    char *input = malloc(100 * sizeof(char));
-    bool has_pipe = read_user_input(input);
-    bool is_exit = strcmp(input, "exit") == 0;
+    char *input;
+    bool has_pipe = read_user_input(&input);
+    // Al terminar la entrada estandar se sale igual que con exit.
+    bool is_exit = strcmp(input, "exit") == 0 || (feof(stdin) && input[0] == '\0');
 
     if (is_exit) {
         printf("bye\n");
@@ -238,16 +355,15 @@ void show_prompt() {
         exit(0);
     }
 
-    if (input == NULL) {
+    // Una linea vacia no es un comando.
+    if (input[strspn(input, " ")] == '\0') {
         free(input);
         return;
     }
     /* Copia de la entrada estandar, y con esta copia
      * se obtiene el nombre del comando. */
-    char *cpy_one = malloc(100 * sizeof(char));
-    char *cpy_two = malloc(100 * sizeof(char));
-    strcpy(cpy_one, input);
-    strcpy(cpy_two, input);
+    char *cpy_one = strdup(input);
+    char *cpy_two = strdup(input);
 
     char *command_name = strtok(cpy_one, " ");
     char **args = split_args(cpy_two);
@@ -282,28 +398,77 @@ void show_prompt() {
             }
             break;
 
-        case COMPACT:
-            if (!verify_num_of_args(args, 0))
+        case REALLOC:
+            if (!verify_num_of_args(args, 2))
                 break;
             else {
-                compact_memory();
+                int pid = atoi(args[0]);
+                Process *process = get_process(process_queue, pid);
+                if (process == NULL) {
+                    printf("Process not found\n");
+                    break;
+                }
+                long size = parse_size(args[1]);
+                if (size < 0) {
+                    printf("Invalid process size\n");
+                    break;
+                }
+                resize_memory(process, size);
             }
             break;
-        case STATE:
-            if (!verify_num_of_args(args, 0))
+
+        case COMPACT:
+            if (args[0] == NULL) {
+                compact_memory(COMPACT_MIN_MOVES);
+            } else if (!verify_num_of_args(args, 1)) {
                 break;
-            else {
+            } else if (strcmp(args[0], "low") == 0) {
+                compact_memory(COMPACT_TO_BASE);
+            } else {
+                printf("Invalid compaction policy, use: compact [low]\n");
+            }
+            break;
+        case STATE:
+            if (args[0] == NULL) {
                 report_memory();
+            } else if (!verify_num_of_args(args, 1)) {
+                break;
+            } else if (strcmp(args[0], "--summary") == 0) {
+                report_summary();
+            } else {
+                printf("Invalid option, use: state [--summary]\n");
             }
             break;
         case MKPS:
-            if (!verify_num_of_args(args, 3))
+            if (args[0] == NULL || args[1] == NULL || args[2] == NULL) {
+                printf("Use: mkps <pid> <burst> <size> [arrival] [nice]\n");
+                break;
+            } else if (!verify_num_of_args(args, args[3] == NULL ? 3 : args[4] == NULL ? 4 : 5))
                 break;
             else {
                 int pid = atoi(args[0]);
                 int burst = atoi(args[1]);
-                int size = atoi(args[2]);
-                Process *process = make_process(pid, burst, size);
+                long size = parse_size(args[2]);
+                // Sin momento de llegada el proceso llega al inicio de la planificacion.
+                int arrival = args[3] != NULL ? atoi(args[3]) : 0;
+                int nice = args[3] != NULL && args[4] != NULL ? atoi(args[4]) : 0;
+                if (size <= 0) {
+                    printf("Invalid memory size, use a number with an optional K, M, G or T suffix\n");
+                    break;
+                }
+                if (burst <= 0) {
+                    printf("Invalid burst time\n");
+                    break;
+                }
+                if (arrival < 0) {
+                    printf("Invalid arrival time\n");
+                    break;
+                }
+                if (nice < MIN_NICE || nice > MAX_NICE) {
+                    printf("Invalid nice value, use a number between %d and %d\n", MIN_NICE, MAX_NICE);
+                    break;
+                }
+                Process *process = make_process(pid, burst, size, arrival, nice);
                 if (contains(process_queue, process, compare_process)) {
                     printf("Process already exist\n");
                     break;
@@ -328,6 +493,7 @@ void show_prompt() {
                     printf("Process not found\n");
                     break;
                 }
+                swap_release(process);
                 free_memory(pid);
                 kill_process(process_queue, pid);
             }
@@ -358,10 +524,226 @@ void show_prompt() {
                 shortest_job_first(process_queue);
             }
             break;
+        case SRTF:
+            if (!verify_num_of_args(args, 0))
+                break;
+            else {
+                shortest_remaining_time_first(process_queue);
+            }
+            break;
+        case MLFQ:
+            // Sin argumentos se usa la configuracion actual.
+            if (args[0] != NULL) {
+                long quanta[MLFQ_MAX_LEVELS];
+                int num_levels = 0;
+                char *end;
+                long boost_period = strtol(args[0], &end, 10);
+                bool valid = *end == '\0';
+                while (valid && args[num_levels + 1] != NULL && num_levels < MLFQ_MAX_LEVELS) {
+                    quanta[num_levels] = strtol(args[num_levels + 1], &end, 10);
+                    valid = *end == '\0';
+                    num_levels++;
+                }
+                if (!valid || args[num_levels + 1] != NULL
+                    || !configure_mlfq(boost_period, quanta, num_levels)) {
+                    printf("Use: mlfq [<boost period> <quantum> [quantum ...]], with at most %d levels\n",
+                           MLFQ_MAX_LEVELS);
+                    break;
+                }
+            }
+            print_mlfq();
+            multilevel_feedback_queue(process_queue);
+            break;
+        case CFS:
+            if (!verify_num_of_args(args, 0))
+                break;
+            else {
+                completely_fair_scheduler(process_queue);
+            }
+            break;
+        case INIT:
+            if (!verify_num_of_args(args, args[0] != NULL && args[1] != NULL ? 2 : 1))
+                break;
+            else {
+                // Sin tamaño se conserva el de la memoria actual.
+                long size = args[1] != NULL ? parse_size(args[1]) : memory->total_size;
+                if (size < 0) {
+                    printf("Invalid memory size, use a number with an optional K, M, G or T suffix\n");
+                } else if (strcmp(args[0], "blocks") == 0) {
+                    init_memory(BLOCK_MODEL, size);
+                } else if (strcmp(args[0], "bitmap") == 0) {
+                    init_memory(BITMAP_MODEL, size);
+                } else {
+                    printf("Invalid memory model, use blocks or bitmap\n");
+                }
+            }
+            break;
+        case PAGING:
+            if (!verify_num_of_args(args, args[0] != NULL && args[1] != NULL ? 2 : 1))
+                break;
+            else {
+                enum ReplacementPolicy policy;
+                if (!parse_policy(args[0], &policy)) {
+                    printf("Invalid policy, use fifo, lru, clock or aging\n");
+                    break;
+                }
+                long frame_size = args[1] != NULL ? parse_size(args[1]) : DEFAULT_FRAME_SIZE;
+                if (!init_paging(policy, frame_size)) {
+                    printf("Invalid frame size, memory must hold between 1 and %ld frames\n",
+                           MAX_FRAMES);
+                    break;
+                }
+                printf("Paging: %d frames of %ld units, %s replacement\n",
+                       paging->num_frames, paging->frame_size, policy_name(paging->policy));
+            }
+            break;
+        case REF:
+            if (paging == NULL) {
+                printf("Paging is disabled, use: paging <fifo|lru|clock|aging> [frame size]\n");
+            } else if (args[0] != NULL && strcmp(args[0], "--trace") == 0) {
+                if (verify_num_of_args(args, 2)) {
+                    replay_trace_file(args[1]);
+                }
+            } else if (args[0] == NULL || args[1] == NULL) {
+                printf("Error: missing arguments.\n");
+            } else {
+                replay_reference_string(atoi(args[0]), &args[1]);
+            }
+            break;
+        case PAGES:
+            if (!verify_num_of_args(args, 0))
+                break;
+            else if (paging == NULL) {
+                printf("Paging is disabled, use: paging <fifo|lru|clock|aging> [frame size]\n");
+            } else {
+                report_paging();
+            }
+            break;
+
+        case REPLAY:
+            if (verify_num_of_args(args, 2))
+                replay_trace(args[0], args[1]);
+            break;
+
+        case ADDR:
+            if (verify_num_of_args(args, 1)) {
+                char *end;
+                long address = strtol(args[0], &end, 0);
+                if (*end != '\0') {
+                    printf("Invalid address\n");
+                } else {
+                    report_address(address);
+                }
+            }
+            break;
+
+        case ADDRS:
+            if (verify_num_of_args(args, 1) && !report_address_file(args[0]))
+                printf("Could not read %s\n", args[0]);
+            break;
+
+        case THREADS:
+            if (args[0] == NULL || args[1] == NULL) {
+                printf("Use: threads <fit> <events> [max threads]\n");
+            } else if (args[2] == NULL || verify_num_of_args(args, 3)) {
+                long events = atol(args[1]);
+                // Cada hilo tiene una arena de al menos una unidad de la memoria actual.
+                long cores = sysconf(_SC_NPROCESSORS_ONLN);
+                int max_threads = args[2] != NULL ? atoi(args[2])
+                                                  : (int) (cores < memory->total_size ? cores : memory->total_size);
+                if (events <= 0 || max_threads <= 0 || events > INT32_MAX || max_threads > memory->total_size) {
+                    printf("Use: threads <fit> <events> [max threads], with at most %ld threads\n",
+                           memory->total_size);
+                } else {
+                    run_concurrent(args[0], events, max_threads);
+                }
+            }
+            break;
+
+        case BACKING:
+            if (args[0] == NULL) {
+                report_backing();
+            } else if (!verify_num_of_args(args, 1)) {
+                break;
+            } else if (strcmp(args[0], "on") == 0) {
+                if (!enable_backing())
+                    printf("Could not map %ld bytes\n", memory->total_size);
+            } else if (strcmp(args[0], "off") == 0) {
+                disable_backing();
+            } else if (strcmp(args[0], "verify") == 0) {
+                verify_backing();
+            } else {
+                printf("Use: backing [on | off | verify]\n");
+            }
+            break;
+
+        case SWAP:
+            if (args[0] == NULL) {
+                report_swap();
+            } else if (strcmp(args[0], "off") == 0) {
+                if (verify_num_of_args(args, 1))
+                    disable_swap(process_queue);
+            } else if (strcmp(args[0], "on") == 0 && args[1] != NULL
+                       && (args[2] == NULL || (args[3] == NULL && atoi(args[2]) > 0))) {
+                enable_swap(args[1], args[2] != NULL ? atoi(args[2]) : DEFAULT_SWAP_THREADS);
+            } else {
+                printf("Use: swap [on <file> [I/O threads] | off]\n");
+            }
+            break;
+
+        case SIMULATE:
+            if (args[0] == NULL || args[1] == NULL) {
+                printf("Use: simulate <fcfs|sjf|srtf|rr|mlfq|cfs> <jobs> [quantum]\n");
+            } else if (args[2] == NULL || verify_num_of_args(args, 3)) {
+                SchedulerPolicy *policy = find_policy(args[0]);
+                long jobs = atol(args[1]);
+                int quantum = args[2] != NULL ? atoi(args[2]) : DEFAULT_QUANTUM;
+                if (policy == NULL || jobs <= 0 || jobs > MAX_WORKLOAD_JOBS || quantum <= 0) {
+                    printf("Use: simulate <fcfs|sjf|srtf|rr|mlfq|cfs> <jobs> [quantum], with at most %d jobs\n",
+                           MAX_WORKLOAD_JOBS);
+                } else {
+                    simulate_workload(policy, (int) jobs, quantum);
+                }
+            }
+            break;
+
+        case SAVE:
+            if (verify_num_of_args(args, 1))
+                save_snapshot(process_queue, args[0]);
+            break;
+
+        case LOAD:
+            if (verify_num_of_args(args, 1))
+                load_snapshot(process_queue, args[0]);
+            break;
+
+        case AUTOCOMPACT:
+            if (args[0] == NULL) {
+                report_auto_compaction();
+            } else if (strcmp(args[0], "off") == 0) {
+                if (verify_num_of_args(args, 1))
+                    disable_auto_compaction();
+            } else {
+                double fragmentation = atof(args[0]);
+                double failure_rate = args[1] != NULL ? atof(args[1]) : 1.0;
+                long budget = args[1] != NULL && args[2] != NULL
+                              ? atol(args[2]) : DEFAULT_COMPACTION_BUDGET;
+                if (args[1] != NULL && args[2] != NULL && args[3] != NULL) {
+                    printf("Error: too many arguments.\n");
+                } else if (fragmentation <= 0 || fragmentation > 1 || failure_rate <= 0
+                           || failure_rate > 1 || budget <= 0) {
+                    printf("Use: autocompact <fragmentation 0-1> [failure rate 0-1] [budget us] | off\n");
+                } else {
+                    enable_auto_compaction(fragmentation, failure_rate, budget);
+                }
+            }
+            break;
 
         default:
             bash_commands(has_pipe, input);
             break;
     }
 
+    // La compactacion automatica avanza entre comandos.
+    auto_compact_step();
 }
\ No newline at end of file
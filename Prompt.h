@@ -11,21 +11,33 @@
 #include <sys/wait.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <time.h>
 #include "Queue.h"
 #include "List.h"
 #include "Process.h"
 #include "Memory.h"
+#include "Paging.h"
+#include "Replay.h"
+#include "Snapshot.h"
+#include "Address.h"
+#include "AutoCompact.h"
+#include "Concurrent.h"
+#include "Swap.h"
+#include "Scheduler.h"
+#include "Mlfq.h"
+#include "Cfs.h"
 
 #define READ_END 0
 #define WRITE_END 1
 
-#define MAX_SIZE 1024
-
 static Queue *process_queue;
 
 enum Option {
     ALLOC, FREE, COMPACT, STATE,
-    MKPS, LSP, KILL, RR, FCFS, SJF
+    MKPS, LSP, KILL, RR, FCFS, SJF, SRTF, MLFQ, CFS,
+    INIT, PAGING, REF, PAGES, REPLAY,
+    SAVE, LOAD, REALLOC, ADDR, ADDRS, AUTOCOMPACT,
+    THREADS, BACKING, SWAP, SIMULATE
 };
 
 typedef struct {
@@ -45,13 +57,35 @@ static Pair lookup_table[] = {
         {"rr", RR},
         {"fcfs", FCFS},
         {"sjf", SJF},
+        {"srtf", SRTF},
+        {"mlfq", MLFQ},
+        {"cfs", CFS},
+        {"init", INIT},
+        {"paging", PAGING},
+        {"ref", REF},
+        {"pages", PAGES},
+        {"replay", REPLAY},
+        {"save", SAVE},
+        {"load", LOAD},
+        {"realloc", REALLOC},
+        {"addr", ADDR},
+        {"addrs", ADDRS},
+        {"autocompact", AUTOCOMPACT},
+        {"threads", THREADS},
+        {"backing", BACKING},
+        {"swap", SWAP},
+        {"simulate", SIMULATE},
 };
 
 
 void show_prompt();
 char **split_args_execvp(char *args);
 char **split_args(char *args);
-void init_shell();
+long parse_size(char *text);
+void init_shell(long memory_size);
+bool parse_policy(char *name, enum ReplacementPolicy *policy);
+void replay_reference_string(int pid, char **pages);
+void replay_trace_file(char *path);
 
 
 #endif //SHELL_PROMPT_H
@@ -55,6 +55,9 @@ void *dequeue_at(Queue *queue, int index){
 
     data_removed = current->data;
     previous->next = current->next;
+    if (current == queue->tail) {
+        queue->tail = previous;
+    }
     free(current);
     queue->size--;
 
@@ -120,6 +123,9 @@ void *dequeue_node(Queue *queue, void *data, int (*p_cmp)(void*, void*)){
             }
             data_removed = current->data;
             previous->next = current->next;
+            if (current == queue->tail) {
+                queue->tail = previous;
+            }
             free(current);
             queue->size--;
             return data_removed;
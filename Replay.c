@@ -0,0 +1,327 @@
+//
+// Created by yaelao on 6/14/23.
+//
+
+#include <math.h>
+#include "Replay.h"
+#include "AutoCompact.h"
+
+/**
+ * Esta funcion genera el siguiente numero pseudoaleatorio (xorshift64*). Se usa un generador
+ * propio para que la misma semilla produzca la misma traza en cualquier sistema.
+ * */
+uint64_t next_random(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ULL;
+}
+
+/**
+ * Esta funcion genera un numero pseudoaleatorio uniforme en [0, 1).
+ * */
+double next_uniform(uint64_t *state) {
+    return (double) (next_random(state) >> 11) * 0x1.0p-53;
+}
+
+/**
+ * Genera el tamaño de un proceso sintetico segun la distribucion del origen.
+ * El tamaño queda entre 1 y el tamaño de la memoria.
+ * */
+static long next_size(EventSource *source) {
+    double mean = (double) source->mean_size, size;
+
+    switch (source->distribution) {
+        case UNIFORM_SIZES:
+            size = 1.0 + next_uniform(&source->random) * (2.0 * mean - 1.0);
+            break;
+        case PARETO_SIZES:
+            // Con alfa = 1.5 la media es tres veces el minimo.
+            size = (mean / 3.0) / pow(1.0 - next_uniform(&source->random), 1.0 / 1.5);
+            break;
+        default:
+            size = -mean * log(1.0 - next_uniform(&source->random));
+            break;
+    }
+    if (size < 1.0) {
+        return 1;
+    }
+    return size > (double) memory->total_size ? memory->total_size : (long) size;
+}
+
+/**
+ * Abre el origen de los eventos. Un nombre de la forma
+ * churn:<eventos>[:<semilla>[:<uniform|exp|pareto>]] genera una traza sintetica
+ * de asignaciones y liberaciones al azar; cualquier otro nombre es un archivo.
+ * @param name El nombre del origen.
+ * @param source El origen a inicializar.
+ * @return true si se abrio el origen, false en caso contrario.
+ * */
+static bool open_source(char *name, EventSource *source) {
+    *source = (EventSource) {0};
+
+    if (strncmp(name, "churn:", 6) != 0) {
+        source->file = fopen(name, "r");
+        return source->file != NULL;
+    }
+
+    char *cursor = name + 6, *end;
+    source->remaining = strtol(cursor, &end, 10);
+    long seed = 1;
+    if (*end == ':') {
+        seed = strtol(end + 1, &end, 10);
+    }
+    source->distribution = EXPONENTIAL_SIZES;
+    if (*end == ':') {
+        if (strcmp(end + 1, "uniform") == 0) {
+            source->distribution = UNIFORM_SIZES;
+        } else if (strcmp(end + 1, "pareto") == 0) {
+            source->distribution = PARETO_SIZES;
+        } else if (strcmp(end + 1, "exp") != 0) {
+            return false;
+        }
+    } else if (*end != '\0') {
+        return false;
+    }
+    if (source->remaining <= 0) {
+        return false;
+    }
+
+    // El generador no puede iniciar en 0.
+    source->random = (uint64_t) seed * 0x9E3779B97F4A7C15ULL + 1;
+    // Caben unos 256 procesos del tamaño medio en la memoria.
+    source->mean_size = memory->total_size / 256 > 0 ? memory->total_size / 256 : 1;
+    source->live_capacity = 64;
+    source->live = (int *) malloc(source->live_capacity * sizeof(int));
+    return true;
+}
+
+/**
+ * Cierra el origen de los eventos.
+ * */
+static void close_source(EventSource *source) {
+    if (source->file != NULL) {
+        fclose(source->file);
+    }
+    free(source->line);
+    free(source->live);
+}
+
+/**
+ * Registra que un proceso sintetico obtuvo memoria, para poder liberarlo despues.
+ * */
+static void track_live(EventSource *source, int id) {
+    if (source->file != NULL) {
+        return;
+    }
+    if (source->num_live == source->live_capacity) {
+        source->live_capacity *= 2;
+        source->live = (int *) realloc(source->live, source->live_capacity * sizeof(int));
+    }
+    source->live[source->num_live++] = id;
+}
+
+/**
+ * Obtiene el siguiente evento del origen. Las lineas de un archivo tienen la
+ * forma "a <id> <tamaño>" o "f <id>"; las lineas vacias, las que inician con #
+ * y las que no se entienden se ignoran.
+ * @param source El origen.
+ * @param event Donde se guarda el evento.
+ * @param skipped Se incrementa por cada linea que no se entiende.
+ * @return true si se obtuvo un evento, false si se terminaron.
+ * */
+static bool next_event(EventSource *source, Event *event, long *skipped) {
+    if (source->file == NULL) {
+        if (source->remaining-- <= 0) {
+            return false;
+        }
+        // Se asigna un poco mas de lo que se libera para mantener la memoria llena.
+        if (source->num_live == 0 || next_uniform(&source->random) < 0.55) {
+            *event = (Event) {true, source->next_id++, next_size(source)};
+        } else {
+            int index = (int) (next_random(&source->random) % (uint64_t) source->num_live);
+            *event = (Event) {false, source->live[index], 0};
+            source->live[index] = source->live[--source->num_live];
+        }
+        return true;
+    }
+
+    while (getline(&source->line, &source->line_capacity, source->file) != -1) {
+        char *cursor = source->line, *end;
+        while (*cursor == ' ' || *cursor == '\t') {
+            cursor++;
+        }
+        if (*cursor == '\0' || *cursor == '\n' || *cursor == '#') {
+            continue;
+        }
+
+        char type = *cursor++;
+        event->id = (int) strtol(cursor, &end, 10);
+        if (end == cursor || (type != 'a' && type != 'f')) {
+            (*skipped)++;
+            continue;
+        }
+        event->is_alloc = type == 'a';
+        if (event->is_alloc) {
+            cursor = end;
+            event->size = strtol(cursor, &end, 10);
+            if (end == cursor) {
+                (*skipped)++;
+                continue;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Imprime los resultados de una reproduccion.
+ * */
+static void report_replay(char *fit, ReplayStats *stats, long skipped) {
+    printf("Replayed %ld events with %s in %.3f s (%.0f operations per second)\n",
+           stats->events, fit, stats->seconds,
+           stats->seconds > 0 ? (double) stats->events / stats->seconds : 0.0);
+    printf("Allocations: %ld, failed: %ld (%.2f%%)\n", stats->allocations, stats->failures,
+           stats->allocations > 0
+           ? 100.0 * (double) stats->failures / (double) stats->allocations : 0.0);
+    printf("Frees: %ld, of processes without memory: %ld\n", stats->frees, stats->unknown_frees);
+    printf("Peak memory used: %ld of %ld units (%.2f%%)\n", stats->peak_used, memory->total_size,
+           100.0 * (double) stats->peak_used / (double) memory->total_size);
+    printf("External fragmentation: peak %.4f, final %.4f\n",
+           stats->peak_fragmentation, external_fragmentation());
+
+    ScanStats scan = strcmp(fit, "nf") == 0 ? memory->next_fit_stats : memory->first_fit_stats;
+    if ((strcmp(fit, "ff") == 0 || strcmp(fit, "nf") == 0) && scan.searches > 0) {
+        printf("Blocks scanned per allocation: %.2f\n",
+               (double) scan.scanned / (double) scan.searches);
+    }
+    if (skipped > 0) {
+        printf("Skipped %ld malformed lines\n", skipped);
+    }
+    if (memory->backing != NULL) {
+        report_backing();
+    }
+}
+
+/**
+ * Esta funcion reproduce una traza de asignaciones y liberaciones con un
+ * algoritmo de asignacion, sin imprimir nada por evento, y reporta las
+ * operaciones por segundo, la tasa de fallos y la mayor fragmentacion.
+ * La traza se reproduce en una memoria aparte del mismo modelo y tamaño, asi
+ * que la memoria actual no cambia; los procesos de la traza no se agregan a
+ * la cola de procesos.
+ * @param fit El algoritmo de asignacion de memoria.
+ * @param name El archivo de la traza o churn:<eventos>[:<semilla>[:<distribucion>]].
+ * @return true si se reprodujo la traza, false en caso contrario.
+ * */
+bool replay_trace(char *fit, char *name) {
+    EventSource source;
+    if (!open_source(name, &source)) {
+        printf("Could not read %s, use a file or churn:<events>[:<seed>[:<uniform|exp|pareto>]]\n",
+               name);
+        close_source(&source);
+        return false;
+    }
+    Memory *current = memory;
+    memory = NULL;
+    init_memory(current->model, current->total_size);
+    // La generacion sigue a la de la memoria actual para que ningun cursor de la
+    // compactacion automatica parezca al dia en la otra memoria.
+    memory->generation = current->generation + 1;
+    if (!select_fit(fit)) {
+        release_memory();
+        memory = current;
+        close_source(&source);
+        return false;
+    }
+
+    // Los procesos de la traza, por identificador; los liberados se reutilizan.
+    HashMap *slot_of = create_hash(1024);
+    int num_slots = 0, capacity = 1024, num_unused = 0;
+    Process **processes = (Process **) malloc(capacity * sizeof(Process *));
+    int *unused = (int *) malloc(capacity * sizeof(int));
+
+    ReplayStats stats = {0};
+    long skipped = 0;
+    int sample = memory->model == BITMAP_MODEL ? FRAGMENTATION_SAMPLE : 1;
+    Event event;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while (next_event(&source, &event, &skipped)) {
+        stats.events++;
+
+        if (event.is_alloc) {
+            stats.allocations++;
+            if (hash_get(slot_of, event.id) != NOT_FOUND) {
+                stats.failures++;
+                continue;
+            }
+
+            int slot;
+            if (num_unused > 0) {
+                slot = unused[--num_unused];
+            } else {
+                if (num_slots == capacity) {
+                    capacity *= 2;
+                    processes = (Process **) realloc(processes, capacity * sizeof(Process *));
+                    unused = (int *) realloc(unused, capacity * sizeof(int));
+                }
+                slot = num_slots++;
+                processes[slot] = (Process *) malloc(sizeof(Process));
+            }
+            *processes[slot] = (Process) {.pid = event.id, .state = NEW, .size = event.size};
+
+            if (allocate_memory(processes[slot], fit) < 0) {
+                stats.failures++;
+                unused[num_unused++] = slot;
+            } else {
+                hash_put(slot_of, event.id, slot);
+                track_live(&source, event.id);
+            }
+        } else {
+            int slot = hash_get(slot_of, event.id);
+            stats.frees++;
+            if (slot == NOT_FOUND) {
+                stats.unknown_frees++;
+                continue;
+            }
+            free_memory(event.id);
+            hash_remove(slot_of, event.id);
+            unused[num_unused++] = slot;
+        }
+
+        // Si esta activa, la compactacion automatica avanza entre eventos.
+        auto_compact_step();
+
+        long used = memory->total_size - memory->remaining_size;
+        stats.peak_used = used > stats.peak_used ? used : stats.peak_used;
+        if (stats.events % sample == 0) {
+            double fragmentation = external_fragmentation();
+            if (fragmentation > stats.peak_fragmentation) {
+                stats.peak_fragmentation = fragmentation;
+            }
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    stats.seconds = (double) (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    report_replay(fit, &stats, skipped);
+
+    // La memoria de la traza apunta a sus procesos, asi que se libera antes que ellos.
+    long generation = memory->generation;
+    release_memory();
+    memory = current;
+    memory->generation = generation + 1;
+    for (int i = 0; i < num_slots; i++) {
+        free(processes[i]);
+    }
+    free(processes);
+    free(unused);
+    clear_hash(slot_of);
+    close_source(&source);
+    return true;
+}
@@ -0,0 +1,94 @@
+//
+// Created by yaelao on 6/14/23.
+//
+
+#ifndef SHELL_REPLAY_H
+#define SHELL_REPLAY_H
+
+#include <stdint.h>
+#include <time.h>
+#include "Memory.h"
+#include "Hash.h"
+
+// En el modelo de mapa de bits la fragmentacion se mide cada FRAGMENTATION_SAMPLE eventos,
+// porque medirla recorre el mapa.
+#define FRAGMENTATION_SAMPLE 1024
+
+/**
+ * Distribucion de los tamaños de una traza sintetica.
+ * UNIFORM_SIZES: uniforme entre 1 y el doble de la media.
+ * EXPONENTIAL_SIZES: exponencial; muchos procesos pequeños y pocos grandes.
+ * PARETO_SIZES: de cola pesada; algunos procesos son mucho mas grandes que la media.
+ * */
+enum SizeDistribution {
+    UNIFORM_SIZES, EXPONENTIAL_SIZES, PARETO_SIZES
+};
+
+/**
+ * Estructura que representa un evento de una traza de asignaciones.
+ * @param is_alloc true para asignar memoria, false para liberarla.
+ * @param id El identificador del proceso.
+ * @param size El tamaño del proceso (solo para asignar).
+ * */
+typedef struct {
+    bool is_alloc;
+    int id;
+    long size;
+} Event;
+
+/**
+ * Estructura que representa el origen de los eventos de una reproduccion:
+ * un archivo que se lee linea por linea o una traza sintetica que se genera
+ * a partir de una semilla.
+ * @param file El archivo de la traza, NULL si es sintetica.
+ * @param line El buffer de la linea actual del archivo.
+ * @param line_capacity El tamaño del buffer de la linea.
+ * @param remaining El numero de eventos sinteticos que faltan.
+ * @param random El estado del generador de numeros aleatorios.
+ * @param distribution La distribucion de los tamaños sinteticos.
+ * @param mean_size El tamaño medio de los procesos sinteticos.
+ * @param live Los identificadores de los procesos sinteticos con memoria.
+ * @param num_live El numero de procesos sinteticos con memoria.
+ * @param live_capacity El numero de identificadores que caben en live.
+ * @param next_id El identificador del siguiente proceso sintetico.
+ * */
+typedef struct {
+    FILE *file;
+    char *line;
+    size_t line_capacity;
+    long remaining;
+    uint64_t random;
+    enum SizeDistribution distribution;
+    long mean_size;
+    int *live;
+    int num_live;
+    int live_capacity;
+    int next_id;
+} EventSource;
+
+/**
+ * Estructura que representa los resultados de una reproduccion.
+ * @param events El numero de eventos reproducidos.
+ * @param allocations El numero de asignaciones intentadas.
+ * @param failures El numero de asignaciones que fallaron.
+ * @param frees El numero de liberaciones.
+ * @param unknown_frees El numero de liberaciones de procesos sin memoria.
+ * @param peak_used La mayor cantidad de memoria asignada.
+ * @param peak_fragmentation La mayor fragmentacion externa.
+ * @param seconds El tiempo de la reproduccion.
+ * */
+typedef struct {
+    long events;
+    long allocations;
+    long failures;
+    long frees;
+    long unknown_frees;
+    long peak_used;
+    double peak_fragmentation;
+    double seconds;
+} ReplayStats;
+
+uint64_t next_random(uint64_t *state);
+double next_uniform(uint64_t *state);
+bool replay_trace(char *fit, char *source);
+#endif //SHELL_REPLAY_H
@@ -0,0 +1,73 @@
+//
+// Created by yaelao on 6/21/23.
+//
+
+#include <string.h>
+#include "Ring.h"
+
+/**
+ * Crea una cola circular vacia.
+ * @param capacity El numero inicial de apuntadores; se redondea a una potencia de dos.
+ * @return La cola creada.
+ * */
+Ring *create_ring(int capacity) {
+    Ring *ring = (Ring *) malloc(sizeof(Ring));
+    ring->capacity = 8;
+    while (ring->capacity < capacity) {
+        ring->capacity *= 2;
+    }
+    ring->items = (void **) malloc(ring->capacity * sizeof(void *));
+    ring->head = 0;
+    ring->size = 0;
+    return ring;
+}
+
+/**
+ * Libera la memoria reservada para la cola. Los datos no se liberan.
+ * */
+void clear_ring(Ring *ring) {
+    free(ring->items);
+    free(ring);
+}
+
+/**
+ * Esta funcion agrega un apuntador al final de la cola. Si no hay lugar, el
+ * arreglo se duplica y los apuntadores que dan la vuelta pasan al final.
+ * */
+void ring_push(Ring *ring, void *data) {
+    if (ring->size == ring->capacity) {
+        ring->items = (void **) realloc(ring->items, 2 * ring->capacity * sizeof(void *));
+        memcpy(ring->items + ring->capacity, ring->items, ring->head * sizeof(void *));
+        ring->capacity *= 2;
+    }
+    ring->items[(ring->head + ring->size++) & (ring->capacity - 1)] = data;
+}
+
+/**
+ * Esta funcion remueve el primer apuntador de la cola.
+ * @return El apuntador, NULL si la cola esta vacia.
+ * */
+void *ring_pop(Ring *ring) {
+    if (ring->size == 0) {
+        return NULL;
+    }
+    void *data = ring->items[ring->head];
+    ring->head = (ring->head + 1) & (ring->capacity - 1);
+    ring->size--;
+    return data;
+}
+
+/**
+ * Obtiene el primer apuntador de la cola sin removerlo.
+ * @return El apuntador, NULL si la cola esta vacia.
+ * */
+void *ring_front(Ring *ring) {
+    return ring->size > 0 ? ring->items[ring->head] : NULL;
+}
+
+/**
+ * Indica si la cola esta vacia.
+ * */
+bool is_ring_empty(Ring *ring) {
+    return ring->size == 0;
+}
@@ -0,0 +1,32 @@
+//
+// Created by yaelao on 6/21/23.
+//
+
+#ifndef SHELL_RING_H
+#define SHELL_RING_H
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * Estructura que representa una cola FIFO de apuntadores sobre un arreglo
+ * circular. Agregar y remover no reservan memoria mientras haya lugar.
+ * @param items Los apuntadores.
+ * @param head La posicion del primero.
+ * @param size El numero de apuntadores.
+ * @param capacity El numero de apuntadores que caben en items; siempre es una potencia de dos.
+ * */
+typedef struct {
+    void **items;
+    int head;
+    int size;
+    int capacity;
+} Ring;
+
+Ring *create_ring(int capacity);
+void clear_ring(Ring *ring);
+void ring_push(Ring *ring, void *data);
+void *ring_pop(Ring *ring);
+void *ring_front(Ring *ring);
+bool is_ring_empty(Ring *ring);
+#endif //SHELL_RING_H
@@ -0,0 +1,180 @@
+//
+// Created by yaelao on 6/21/23.
+//
+
+#ifndef SHELL_SCHEDULER_H
+#define SHELL_SCHEDULER_H
+
+#include <stdint.h>
+#include <time.h>
+#include "Process.h"
+#include "Heap.h"
+#include "Ring.h"
+
+// Las cargas sinteticas usan siempre la misma semilla para que las politicas se puedan comparar.
+#define WORKLOAD_SEED 0x5EEDULL
+
+// Rafaga media de una carga sintetica, en ms.
+#define WORKLOAD_MEAN_BURST 10.0
+
+// Fraccion del tiempo que el CPU estaria ocupado con una carga sintetica.
+#define WORKLOAD_LOAD 0.9
+
+// Quantum de las cargas sinteticas si no se indica otro, en ms.
+#define DEFAULT_QUANTUM 10
+
+// El mayor numero de trabajos de una carga sintetica.
+#define MAX_WORKLOAD_JOBS (20 * 1000 * 1000)
+
+/**
+ * Tipos de evento del planificador.
+ * ARRIVAL: llegan los trabajos del instante.
+ * DISPATCH: el CPU esta libre y se elige el siguiente trabajo.
+ * QUANTUM_EXPIRY: se le acaba el quantum al trabajo en el CPU.
+ * COMPLETION: termina el trabajo en el CPU.
+ * TICK: se cumple el periodo de la politica.
+ * */
+enum SchedulerEvent {
+    ARRIVAL, DISPATCH, QUANTUM_EXPIRY, COMPLETION, TICK
+};
+
+/**
+ * Motivo por el que un trabajo entra a la cola de listos.
+ * ARRIVED: acaba de llegar.
+ * EXPIRED: se le acabo el quantum.
+ * PREEMPTED: lo saco del CPU un trabajo que llego.
+ * */
+enum ReadyReason {
+    ARRIVED, EXPIRED, PREEMPTED
+};
+
+/**
+ * Estructura que representa el estado de un proceso durante una planificacion.
+ * @param process El proceso.
+ * @param index La posicion del proceso en la cola; desempata llegadas simultaneas.
+ * @param arrival El momento en que llega.
+ * @param burst Su tiempo de rafaga.
+ * @param remaining El tiempo de rafaga que le falta; si esta en el CPU, el que le
+ * faltaba al entrar.
+ * @param started El momento en que entro al CPU por primera vez, -1 si no ha entrado.
+ * @param dispatched El momento en que entro al CPU por ultima vez.
+ * @param finished El momento en que termino.
+ * @param event El orden de su evento pendiente; los eventos con otro orden se ignoran.
+ * @param level Su nivel de prioridad en las politicas con niveles; 0 es el mas alto.
+ * */
+typedef struct {
+    Process *process;
+    int index;
+    long arrival;
+    long burst;
+    long remaining;
+    long started;
+    long dispatched;
+    long finished;
+    long event;
+    int level;
+} Job;
+
+struct Scheduler;
+
+/**
+ * Estructura que representa una politica de planificacion. El motor decide
+ * cuando se elige un trabajo; la politica decide cual y por cuanto tiempo.
+ * @param name El nombre de la politica.
+ * @param create Crea la cola de listos.
+ * @param destroy Libera la cola de listos.
+ * @param enqueue Agrega un trabajo a la cola de listos.
+ * @param pick Remueve el siguiente trabajo de la cola, NULL si esta vacia.
+ * @param peek Obtiene el siguiente trabajo sin removerlo, NULL si la cola esta vacia.
+ * @param slice El tiempo que un trabajo puede estar en el CPU, 0 si hasta terminar.
+ * @param preempts Indica si un trabajo que llega saca al que esta en el CPU; NULL si nunca.
+ * @param period Cada cuanto se llama tick, 0 si nunca; NULL si la politica no tiene periodo.
+ * @param tick Se llama cada periodo mientras hay trabajos listos o en el CPU.
+ * */
+typedef struct {
+    char *name;
+    void *(*create)(struct Scheduler *scheduler);
+    void (*destroy)(void *ready);
+    void (*enqueue)(struct Scheduler *scheduler, Job *job, enum ReadyReason reason);
+    Job *(*pick)(struct Scheduler *scheduler);
+    Job *(*peek)(struct Scheduler *scheduler);
+    long (*slice)(struct Scheduler *scheduler, Job *job);
+    bool (*preempts)(struct Scheduler *scheduler, Job *running, Job *arrived);
+    long (*period)(struct Scheduler *scheduler);
+    void (*tick)(struct Scheduler *scheduler);
+} SchedulerPolicy;
+
+/**
+ * Estructura que representa un planificador de eventos discretos: el reloj
+ * salta de un evento al siguiente, asi que el costo depende del numero de
+ * eventos y no del tiempo simulado.
+ * @param policy La politica.
+ * @param ready La cola de listos de la politica.
+ * @param quantum El quantum de las politicas que lo usan.
+ * @param events Los eventos pendientes, por tiempo y despues por orden de creacion.
+ * @param jobs Los trabajos, por momento de llegada.
+ * @param num_jobs El numero de trabajos.
+ * @param next_arrival La posicion del siguiente trabajo que llega.
+ * @param running El trabajo en el CPU, NULL si esta libre.
+ * @param last El ultimo trabajo que estuvo en el CPU.
+ * @param now El tiempo actual.
+ * @param sequence El orden del siguiente evento o elemento de una cola.
+ * @param dispatch_pending true si ya hay un evento DISPATCH pendiente.
+ * @param tick_pending true si ya hay un evento TICK pendiente.
+ * @param trace true para imprimir cada evento.
+ * @param uses_memory true si los procesos tienen memoria: se liberan al terminar
+ * y pueden estar en el swap.
+ * @param finished_jobs El numero de trabajos terminados.
+ * @param dropped_jobs El numero de trabajos que no pudieron regresar del swap.
+ * @param processed_events El numero de eventos atendidos.
+ * @param context_switches El numero de veces que el CPU cambio de trabajo.
+ * @param busy_time El tiempo que el CPU estuvo ocupado.
+ * @param total_waiting La suma de los tiempos de espera.
+ * @param total_turn_around La suma de los tiempos de retorno.
+ * @param total_response La suma de los tiempos hasta entrar al CPU por primera vez.
+ * @param max_waiting El mayor tiempo de espera.
+ * @param total_slowdown La suma de los tiempos de retorno divididos entre la rafaga.
+ * @param total_slowdown_squares La suma de los cuadrados de esas proporciones.
+ * */
+typedef struct Scheduler {
+    SchedulerPolicy *policy;
+    void *ready;
+    long quantum;
+    Heap *events;
+    Job *jobs;
+    int num_jobs;
+    int next_arrival;
+    Job *running;
+    Job *last;
+    long now;
+    long sequence;
+    bool dispatch_pending;
+    bool tick_pending;
+    bool trace;
+    bool uses_memory;
+    int finished_jobs;
+    int dropped_jobs;
+    long processed_events;
+    long context_switches;
+    long busy_time;
+    double total_waiting;
+    double total_turn_around;
+    double total_response;
+    long max_waiting;
+    double total_slowdown;
+    double total_slowdown_squares;
+} Scheduler;
+
+extern SchedulerPolicy fcfs_policy;
+extern SchedulerPolicy sjf_policy;
+extern SchedulerPolicy srtf_policy;
+extern SchedulerPolicy rr_policy;
+
+SchedulerPolicy *find_policy(char *name);
+Scheduler *create_scheduler(SchedulerPolicy *policy, long quantum, Job *jobs, int num_jobs);
+void release_scheduler(Scheduler *scheduler);
+void run_scheduler(Scheduler *scheduler);
+void report_scheduler(Scheduler *scheduler);
+void schedule_queue(Queue *queue, SchedulerPolicy *policy, long quantum);
+void simulate_workload(SchedulerPolicy *policy, int num_jobs, long quantum);
+#endif //SHELL_SCHEDULER_H
@@ -0,0 +1,324 @@
+//
+// Created by yaelao on 6/15/23.
+//
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Snapshot.h"
+#include "Swap.h"
+
+/**
+ * Compara dos segmentos por su base.
+ * */
+static int compare_segment(const void *data1, const void *data2) {
+    long base1 = ((SnapshotSegment *) data1)->base;
+    long base2 = ((SnapshotSegment *) data2)->base;
+    return (base1 > base2) - (base1 < base2);
+}
+
+/**
+ * Obtiene la posicion en la cola del dueño de un segmento.
+ * @param position_of La posicion de cada proceso de la cola, por pid.
+ * @param process El dueño del segmento, NULL si esta libre.
+ * @param valid Se vuelve false si el proceso no esta en la cola.
+ * @return La posicion, NO_OWNER si el segmento esta libre.
+ * */
+static int owner_of(HashMap *position_of, Process *process, bool *valid) {
+    if (process == NULL) {
+        return NO_OWNER;
+    }
+    int position = hash_get(position_of, process->pid);
+    *valid = *valid && position != NOT_FOUND;
+    return position;
+}
+
+/**
+ * Esta funcion guarda la cola de procesos y la memoria en un archivo binario.
+ * @param queue La cola de procesos.
+ * @param path El archivo donde se guarda el snapshot.
+ * @return true si se guardo el snapshot, false en caso contrario.
+ * */
+bool save_snapshot(Queue *queue, char *path) {
+    // Un proceso con una lectura del swap en curso ya tiene memoria; se guarda en READY.
+    for (Node *node = queue->head; node != NULL; node = (Node *) node->next) {
+        swap_in_finish((Process *) node->data);
+    }
+
+    BlockTable *blocks = memory->blocks;
+    bool bitmap_model = memory->model == BITMAP_MODEL;
+    SnapshotHeader header = {
+            SNAPSHOT_MAGIC, SNAPSHOT_VERSION, memory->model, memory->mode, NO_BLOCK,
+            memory->total_size, bitmap_model ? memory->unit_size : 1, queue->size,
+            bitmap_model ? memory->allocated_blocks : blocks->size
+    };
+
+    SnapshotProcess *processes = (SnapshotProcess *) malloc(
+            (header.num_processes + 1) * sizeof(SnapshotProcess));
+    SnapshotSegment *segments = (SnapshotSegment *) malloc(
+            (header.num_segments + 1) * sizeof(SnapshotSegment));
+    HashMap *position_of = create_hash(queue->size * 2 + 1);
+
+    int position = 0;
+    for (Node *node = queue->head; node != NULL; node = (Node *) node->next) {
+        Process *process = (Process *) node->data;
+        // Los bytes del swap no se guardan; un proceso en el swap queda sin memoria.
+        processes[position] = (SnapshotProcess) {
+                process->pid, process->state == SWAPPED ? NEW : process->state, process->burst_time,
+                process->waiting_time, process->turn_around_time, process->t_time, process->size,
+                process->arrival_time, process->nice, process->vruntime
+        };
+        hash_put(position_of, process->pid, position++);
+    }
+
+    bool valid = true;
+    if (bitmap_model) {
+        for (int i = 0; i < memory->allocated_blocks; i++) {
+            Allocation *allocation = &memory->allocations[i];
+            segments[i] = (SnapshotSegment) {
+                    allocation->base, allocation->size,
+                    owner_of(position_of, allocation->process, &valid), 0
+            };
+        }
+        qsort(segments, header.num_segments, sizeof(SnapshotSegment), compare_segment);
+    } else {
+        position = 0;
+        for (int i = blocks->head; i != NO_BLOCK; i = blocks->slots[i].next) {
+            MemoryBlock *block = block_at(blocks, i);
+            if (i == memory->cursor) {
+                header.cursor = position;
+            }
+            segments[position] = (SnapshotSegment) {
+                    block->base, block->size, owner_of(position_of, block->process, &valid), 0
+            };
+            position++;
+        }
+    }
+
+    FILE *file = NULL;
+    if (!valid) {
+        printf("Could not save, a process with memory is not in the process queue\n");
+    } else if ((file = fopen(path, "wb")) == NULL) {
+        printf("Could not open %s\n", path);
+        valid = false;
+    } else {
+        valid = fwrite(&header, sizeof(header), 1, file) == 1
+                && fwrite(processes, sizeof(SnapshotProcess), header.num_processes, file)
+                   == (size_t) header.num_processes
+                && fwrite(segments, sizeof(SnapshotSegment), header.num_segments, file)
+                   == (size_t) header.num_segments;
+        valid = fclose(file) == 0 && valid;
+        if (valid) {
+            printf("Saved %ld processes and %ld %s to %s\n", header.num_processes,
+                   header.num_segments, bitmap_model ? "allocations" : "blocks", path);
+        } else {
+            printf("Could not write %s\n", path);
+        }
+    }
+
+    free(processes);
+    free(segments);
+    clear_hash(position_of);
+    return valid;
+}
+
+/**
+ * Verifica que un snapshot describa una memoria valida antes de cargarlo, para
+ * no dejar la simulacion a medias si el archivo esta dañado.
+ * @param header El encabezado del snapshot.
+ * @param processes Los procesos del snapshot.
+ * @param segments Los segmentos del snapshot.
+ * @return true si el snapshot es valido, false en caso contrario.
+ * */
+static bool verify_snapshot(SnapshotHeader *header, SnapshotProcess *processes,
+                            SnapshotSegment *segments) {
+    long total_size = header->total_size;
+    if (header->model > BITMAP_MODEL || header->mode > TLSF_MODE || total_size <= 0
+        || total_size > MAX_MEMORY_SIZE) {
+        return false;
+    }
+    bool bitmap_model = header->model == BITMAP_MODEL;
+    long unit_size = bitmap_model ? bitmap_unit_size(total_size) : 1;
+    if (header->unit_size != unit_size || total_size % unit_size != 0
+        || (bitmap_model && header->mode != PARTITION_MODE)
+        || header->cursor < NO_BLOCK || header->cursor >= header->num_segments) {
+        return false;
+    }
+
+    // Cada pid aparece una vez y cada proceso es dueño de a lo mas un segmento.
+    HashMap *pids = create_hash((int) header->num_processes * 2 + 1);
+    bool *owned = (bool *) calloc(header->num_processes + 1, sizeof(bool));
+    bool valid = true;
+    for (long i = 0; i < header->num_processes && valid; i++) {
+        valid = hash_get(pids, processes[i].pid) == NOT_FOUND && processes[i].size > 0
+                && processes[i].state >= NEW && processes[i].state <= TERMINATED
+                && processes[i].arrival_time >= 0 && processes[i].vruntime >= 0
+                && processes[i].nice >= MIN_NICE && processes[i].nice <= MAX_NICE;
+        hash_put(pids, processes[i].pid, (int) i);
+    }
+
+    long end = 0;
+    for (long i = 0; i < header->num_segments && valid; i++) {
+        SnapshotSegment *segment = &segments[i];
+        int owner = segment->owner;
+        if (segment->base < 0 || segment->size <= 0 || segment->base % unit_size != 0
+            || segment->size % unit_size != 0 || segment->size > total_size - segment->base
+            || owner < NO_OWNER
+            || owner >= header->num_processes || (owner != NO_OWNER && owned[owner])) {
+            valid = false;
+        } else if (bitmap_model) {
+            // Las asignaciones no se enciman y son de un proceso.
+            valid = segment->base >= end && owner != NO_OWNER
+                    && processes[owner].size <= segment->size;
+        } else {
+            // Los bloques cubren la memoria sin huecos; los de buddy estan alineados.
+            valid = segment->base == end
+                    && (owner == NO_OWNER || processes[owner].size <= segment->size)
+                    && (header->mode != BUDDY_MODE || ((segment->size & (segment->size - 1)) == 0
+                                                       && segment->base % segment->size == 0));
+        }
+        if (valid && owner != NO_OWNER) {
+            owned[owner] = true;
+        }
+        end = segment->base + segment->size;
+    }
+    if (!bitmap_model && end != total_size) {
+        valid = false;
+    }
+
+    clear_hash(pids);
+    free(owned);
+    return valid;
+}
+
+/**
+ * Reconstruye la memoria recien inicializada a partir de los segmentos de un
+ * snapshot valido. Los bloques se agregan en orden de direccion al final de la tabla.
+ * @param header El encabezado del snapshot.
+ * @param segments Los segmentos del snapshot.
+ * @param processes Los procesos de la cola, por posicion.
+ * */
+static void restore_memory(SnapshotHeader *header, SnapshotSegment *segments,
+                           Process **processes) {
+    if (header->model == BITMAP_MODEL) {
+        if (header->num_segments > memory->allocations_capacity) {
+            memory->allocations_capacity = (int) header->num_segments;
+            memory->allocations = (Allocation *) realloc(
+                    memory->allocations, memory->allocations_capacity * sizeof(Allocation));
+        }
+        for (int i = 0; i < header->num_segments; i++) {
+            SnapshotSegment *segment = &segments[i];
+            memory->allocations[i] = (Allocation) {
+                    segment->base, segment->size, processes[segment->owner]
+            };
+            bitmap_set_run(memory->bitmap, segment->base / memory->unit_size,
+                           segment->size / memory->unit_size);
+            memory->remaining_size -= segment->size;
+            hash_put(memory->owners, processes[segment->owner]->pid, i);
+        }
+        memory->allocated_blocks = (int) header->num_segments;
+        return;
+    }
+
+    empty_memory(header->mode);
+    int previous = NO_BLOCK;
+    for (int i = 0; i < header->num_segments; i++) {
+        SnapshotSegment *segment = &segments[i];
+        if (segment->owner == NO_OWNER) {
+            previous = make_memory_block(previous, segment->base, segment->size);
+        } else {
+            previous = table_insert_after(memory->blocks, previous);
+            MemoryBlock *block = block_at(memory->blocks, previous);
+            block->base = segment->base;
+            block->size = segment->size;
+            block->process = processes[segment->owner];
+            memory->allocated_blocks++;
+            hash_put(memory->owners, block->process->pid, previous);
+        }
+        if (i == header->cursor) {
+            memory->cursor = previous;
+        }
+    }
+}
+
+/**
+ * Esta funcion reemplaza la cola de procesos y la memoria por las de un
+ * snapshot. El archivo se mapea en memoria y los registros se usan tal cual;
+ * solo se crean los nodos de la cola y los bloques de la tabla.
+ * @param queue La cola de procesos.
+ * @param path El archivo del snapshot.
+ * @return true si se cargo el snapshot, false en caso contrario.
+ * */
+bool load_snapshot(Queue *queue, char *path) {
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) < 0) {
+        printf("Could not open %s\n", path);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+
+    size_t length = (size_t) info.st_size;
+    void *data = length >= sizeof(SnapshotHeader)
+                 ? mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (data == MAP_FAILED) {
+        printf("%s is not a snapshot\n", path);
+        return false;
+    }
+
+    SnapshotHeader *header = (SnapshotHeader *) data;
+    SnapshotProcess *records = (SnapshotProcess *) (header + 1);
+    SnapshotSegment *segments = (SnapshotSegment *) (records + (header->num_processes > 0
+                                                                ? header->num_processes : 0));
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) {
+        printf("%s is not a snapshot\n", path);
+    } else if (header->version != SNAPSHOT_VERSION) {
+        printf("%s has snapshot version %u, expected %d\n", path, header->version, SNAPSHOT_VERSION);
+    } else if (header->num_processes < 0 || header->num_processes > INT32_MAX
+               || header->num_segments < 0 || header->num_segments > INT32_MAX
+               || length != sizeof(SnapshotHeader)
+                            + header->num_processes * sizeof(SnapshotProcess)
+                            + header->num_segments * sizeof(SnapshotSegment)
+               || !verify_snapshot(header, records, segments)) {
+        printf("%s is damaged\n", path);
+    } else {
+        // Los procesos que se reemplazan dejan libre su espacio en el swap.
+        for (Node *node = queue->head; node != NULL; node = (Node *) node->next) {
+            swap_release((Process *) node->data);
+        }
+        // La memoria se libera antes que la cola porque sus bloques apuntan a los procesos.
+        init_memory(header->model, header->total_size);
+        clear_queue(queue);
+
+        Process **processes = (Process **) malloc((header->num_processes + 1) * sizeof(Process *));
+        for (int i = 0; i < header->num_processes; i++) {
+            SnapshotProcess *record = &records[i];
+            Process process = {
+                    .pid = record->pid, .state = record->state, .burst_time = record->burst_time,
+                    .waiting_time = record->waiting_time, .turn_around_time = record->turn_around_time,
+                    .t_time = record->t_time, .size = record->size,
+                    .arrival_time = record->arrival_time, .nice = record->nice,
+                    .vruntime = record->vruntime
+            };
+            enqueue(queue, &process, sizeof(Process));
+            processes[i] = (Process *) queue->tail->data;
+        }
+        restore_memory(header, segments, processes);
+        free(processes);
+        if (memory->backing != NULL) {
+            fill_backing();
+        }
+
+        printf("Loaded %ld processes and %ld %s from %s\n", header->num_processes,
+               header->num_segments, header->model == BITMAP_MODEL ? "allocations" : "blocks", path);
+        munmap(data, length);
+        return true;
+    }
+
+    munmap(data, length);
+    return false;
+}
@@ -0,0 +1,82 @@
+//
+// Created by yaelao on 6/15/23.
+//
+
+#ifndef SHELL_SNAPSHOT_H
+#define SHELL_SNAPSHOT_H
+
+#include <stdint.h>
+#include "Queue.h"
+#include "Process.h"
+#include "Memory.h"
+
+// Los primeros bytes de todo snapshot.
+#define SNAPSHOT_MAGIC "SHSNAP\0"
+
+// Version del formato; cambia cuando cambia algun registro.
+#define SNAPSHOT_VERSION 3
+
+// Segmento sin proceso asignado.
+#define NO_OWNER (-1)
+
+/**
+ * Encabezado de un snapshot. Despues del encabezado siguen num_processes
+ * registros SnapshotProcess y despues num_segments registros SnapshotSegment.
+ * Todos los registros tienen tamaños multiplos de 8 bytes, asi que se leen
+ * directamente del archivo mapeado en memoria.
+ * @param magic SNAPSHOT_MAGIC.
+ * @param version SNAPSHOT_VERSION.
+ * @param model La forma en que se representa la memoria.
+ * @param mode La forma en que se administran los bloques.
+ * @param cursor La posicion del bloque del cursor de next fit, NO_BLOCK si no hay.
+ * @param total_size El tamaño de la memoria.
+ * @param unit_size Las unidades que representa cada bit (BITMAP_MODEL).
+ * @param num_processes El numero de procesos de la cola.
+ * @param num_segments El numero de bloques (BLOCK_MODEL) o de asignaciones (BITMAP_MODEL).
+ * */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t model;
+    uint32_t mode;
+    int32_t cursor;
+    int64_t total_size;
+    int64_t unit_size;
+    int64_t num_processes;
+    int64_t num_segments;
+} SnapshotHeader;
+
+/**
+ * Registro de un proceso de la cola, en el orden de la cola.
+ * */
+typedef struct {
+    int32_t pid;
+    int32_t state;
+    int32_t burst_time;
+    int32_t waiting_time;
+    int32_t turn_around_time;
+    int32_t t_time;
+    int64_t size;
+    int32_t arrival_time;
+    int32_t nice;
+    int64_t vruntime;
+} SnapshotProcess;
+
+/**
+ * Registro de un bloque de memoria (BLOCK_MODEL, en orden de direccion, libres
+ * incluidos) o de una asignacion (BITMAP_MODEL, en orden de direccion).
+ * @param base La direccion donde inicia.
+ * @param size El tamaño.
+ * @param owner La posicion del proceso en la cola, NO_OWNER si esta libre.
+ * @param reserved Siempre 0.
+ * */
+typedef struct {
+    int64_t base;
+    int64_t size;
+    int32_t owner;
+    int32_t reserved;
+} SnapshotSegment;
+
+bool save_snapshot(Queue *queue, char *path);
+bool load_snapshot(Queue *queue, char *path);
+#endif //SHELL_SNAPSHOT_H
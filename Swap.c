@@ -0,0 +1,500 @@
+//
+// Created by yaelao on 6/20/23.
+//
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "Swap.h"
+
+SwapArea *swap_area;
+
+/**
+ * Obtiene los segundos transcurridos desde un instante.
+ * */
+static double seconds_since(struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * Lee o escribe todos los bytes de una operacion, aunque el sistema los
+ * transfiera por partes.
+ * @return true si se transfirieron todos los bytes, false en caso contrario.
+ * */
+static bool transfer(SwapRequest *request) {
+    long done = 0;
+    while (done < request->size) {
+        ssize_t count = request->write
+                        ? pwrite(swap_area->fd, request->buffer + done, request->size - done,
+                                 request->offset + done)
+                        : pread(swap_area->fd, request->buffer + done, request->size - done,
+                                request->offset + done);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        done += count;
+    }
+    return true;
+}
+
+/**
+ * Hilo de entrada/salida: toma operaciones de la cola hasta que el area se desactiva.
+ * */
+static void *run_io_thread(void *data) {
+    (void) data;
+    pthread_mutex_lock(&swap_area->lock);
+    while (true) {
+        while (swap_area->head == NULL && !swap_area->stopping) {
+            pthread_cond_wait(&swap_area->work, &swap_area->lock);
+        }
+        if (swap_area->head == NULL) {
+            break;
+        }
+        SwapRequest *request = swap_area->head;
+        swap_area->head = request->next;
+        if (swap_area->head == NULL) {
+            swap_area->tail = NULL;
+        }
+        pthread_mutex_unlock(&swap_area->lock);
+
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bool failed = !transfer(request);
+        double seconds = seconds_since(&start);
+
+        pthread_mutex_lock(&swap_area->lock);
+        request->failed = failed;
+        request->seconds = seconds;
+        request->done = true;
+        swap_area->io_seconds += seconds;
+        pthread_cond_broadcast(&swap_area->finished);
+    }
+    pthread_mutex_unlock(&swap_area->lock);
+    return NULL;
+}
+
+/**
+ * Agrega una operacion a la cola de los hilos de entrada/salida.
+ * */
+static void submit(SwapEntry *entry, bool write, unsigned char *buffer, long size) {
+    entry->request = (SwapRequest) {write, buffer, size, entry->offset, false, false, 0, NULL};
+    entry->pending = true;
+
+    pthread_mutex_lock(&swap_area->lock);
+    if (swap_area->tail == NULL) {
+        swap_area->head = &entry->request;
+    } else {
+        swap_area->tail->next = &entry->request;
+    }
+    swap_area->tail = &entry->request;
+    pthread_cond_signal(&swap_area->work);
+    pthread_mutex_unlock(&swap_area->lock);
+}
+
+/**
+ * Espera a que termine la ultima operacion de un proceso y libera su buffer,
+ * salvo en una lectura, cuyo buffer se copia despues a la memoria.
+ * @return El tiempo esperado, en segundos.
+ * */
+static double wait_request(SwapEntry *entry) {
+    if (!entry->pending) {
+        return 0;
+    }
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_mutex_lock(&swap_area->lock);
+    while (!entry->request.done) {
+        pthread_cond_wait(&swap_area->finished, &swap_area->lock);
+    }
+    pthread_mutex_unlock(&swap_area->lock);
+    double waited = seconds_since(&start);
+
+    entry->pending = false;
+    if (entry->request.failed) {
+        printf("Swap %s of process %d failed\n", entry->request.write ? "write" : "read", entry->pid);
+    }
+    if (entry->request.write) {
+        free(entry->request.buffer);
+    }
+    return waited;
+}
+
+/**
+ * Obtiene el registro de swap de un proceso, creandolo si no existe.
+ * */
+static SwapEntry *entry_of(int pid) {
+    int index = hash_get(swap_area->entry_of, pid);
+    if (index != NOT_FOUND) {
+        return swap_area->entries[index];
+    }
+    if (swap_area->num_entries == swap_area->entries_capacity) {
+        swap_area->entries_capacity *= 2;
+        swap_area->entries = (SwapEntry **) realloc(
+                swap_area->entries, swap_area->entries_capacity * sizeof(SwapEntry *));
+    }
+    SwapEntry *entry = (SwapEntry *) calloc(1, sizeof(SwapEntry));
+    entry->pid = pid;
+    hash_put(swap_area->entry_of, pid, swap_area->num_entries);
+    swap_area->entries[swap_area->num_entries++] = entry;
+    return entry;
+}
+
+/**
+ * Deja libre para otros procesos el espacio del archivo de un proceso, si tiene.
+ * */
+static void release_extent(SwapEntry *entry) {
+    if (entry->capacity == 0) {
+        return;
+    }
+    if (swap_area->num_extents == swap_area->extents_capacity) {
+        swap_area->extents_capacity *= 2;
+        swap_area->extents = (SwapExtent *) realloc(
+                swap_area->extents, swap_area->extents_capacity * sizeof(SwapExtent));
+    }
+    swap_area->extents[swap_area->num_extents++] = (SwapExtent) {entry->offset, entry->capacity};
+    entry->capacity = 0;
+}
+
+/**
+ * Le da a un proceso un espacio del archivo de swap donde quepan sus bytes.
+ * Su espacio anterior, si no alcanza, queda libre para otros procesos.
+ * */
+static void reserve_extent(SwapEntry *entry, long size) {
+    if (entry->capacity >= size) {
+        return;
+    }
+    release_extent(entry);
+
+    // El primer espacio libre que alcance; si ninguno alcanza, el archivo crece.
+    for (int i = 0; i < swap_area->num_extents; i++) {
+        SwapExtent *extent = &swap_area->extents[i];
+        if (extent->size >= size) {
+            entry->offset = extent->offset;
+            entry->capacity = extent->size;
+            *extent = swap_area->extents[--swap_area->num_extents];
+            return;
+        }
+    }
+    entry->offset = swap_area->end;
+    entry->capacity = size;
+    swap_area->end += size;
+}
+
+/**
+ * Saca un proceso de la memoria: copia sus bytes a un buffer, libera su memoria
+ * y deja la escritura al archivo a los hilos de entrada/salida.
+ * */
+static void swap_out(Process *process) {
+    SwapEntry *entry = entry_of(process->pid);
+    entry->stall += wait_request(entry);
+
+    unsigned char *buffer = (unsigned char *) malloc(process->size);
+    if (memory->backing != NULL) {
+        memcpy(buffer, memory->backing->bytes + base_of(process), process->size);
+    } else {
+        memset(buffer, 0, process->size);
+    }
+    reserve_extent(entry, process->size);
+    free_memory(process->pid);
+    process->state = SWAPPED;
+    entry->swapped = true;
+    entry->swap_outs++;
+    entry->bytes_out += process->size;
+    submit(entry, true, buffer, process->size);
+    printf("Process %d swapped out (%ld bytes)\n", process->pid, process->size);
+}
+
+/**
+ * Compara un proceso con la victima elegida hasta ahora: sale primero el que el
+ * planificador ejecuto hace mas tiempo y, entre esos, el mas grande. Los procesos
+ * en ejecucion y los que aun se estan leyendo del swap no se eligen.
+ * */
+static void consider_victim(Process *process, Process *except, Process **victim, long *victim_used) {
+    if (process == NULL || process == except
+        || (process->state != READY && process->state != WAITING)) {
+        return;
+    }
+    int index = hash_get(swap_area->entry_of, process->pid);
+    long used = index != NOT_FOUND ? swap_area->entries[index]->last_used : 0;
+    if (*victim == NULL || used < *victim_used
+        || (used == *victim_used && process->size > (*victim)->size)) {
+        *victim = process;
+        *victim_used = used;
+    }
+}
+
+/**
+ * Elige el proceso que sale de la memoria.
+ * @param except Un proceso que no se elige.
+ * @return El proceso, NULL si no hay ninguno que se pueda sacar.
+ * */
+static Process *choose_victim(Process *except) {
+    Process *victim = NULL;
+    long victim_used = 0;
+
+    if (memory->model == BITMAP_MODEL) {
+        for (int i = 0; i < memory->allocated_blocks; i++) {
+            consider_victim(memory->allocations[i].process, except, &victim, &victim_used);
+        }
+    } else {
+        BlockTable *blocks = memory->blocks;
+        for (int i = blocks->head; i != NO_BLOCK; i = blocks->slots[i].next) {
+            consider_victim(blocks->slots[i].process, except, &victim, &victim_used);
+        }
+    }
+    return victim;
+}
+
+/**
+ * Esta funcion asigna memoria a un proceso sacando otros procesos al swap
+ * hasta que haya espacio.
+ * @param process El proceso a asignar.
+ * @param fit El algoritmo de asignacion de memoria.
+ * @return La base de la memoria asignada, -1 si no hay espacio ni sacando a todos.
+ * */
+long allocate_with_swap(Process *process, char *fit) {
+    long base = allocate_memory(process, fit);
+    while (base < 0 && process->size <= memory->total_size) {
+        Process *victim = choose_victim(process);
+        if (victim == NULL) {
+            break;
+        }
+        swap_out(victim);
+        base = allocate_memory(process, fit);
+    }
+    return base;
+}
+
+/**
+ * Esta funcion empieza a regresar un proceso del swap sin esperar la lectura:
+ * le asigna memoria, sacando otros si hace falta, y deja la lectura a los
+ * hilos de entrada/salida. Asi el planificador puede adelantar la lectura del
+ * proceso que sigue mientras ejecuta otro.
+ * @param process El proceso.
+ * @return true si la lectura esta en curso, false si el proceso no esta en el swap
+ * o no hay memoria para el.
+ * */
+bool swap_in_start(Process *process) {
+    if (swap_area == NULL || process->state != SWAPPED) {
+        return false;
+    }
+    SwapEntry *entry = entry_of(process->pid);
+    if (!entry->swapped) {
+        return entry->pending;
+    }
+    // La escritura anterior tiene que terminar antes de leer el archivo.
+    entry->stall += wait_request(entry);
+
+    if (allocate_with_swap(process, current_fit()) < 0) {
+        process->state = SWAPPED;
+        return false;
+    }
+    // Sigue en SWAPPED hasta que termine la lectura, para que no se elija como victima.
+    process->state = SWAPPED;
+    entry->swapped = false;
+    submit(entry, false, (unsigned char *) malloc(process->size), process->size);
+    return true;
+}
+
+/**
+ * Esta funcion espera la lectura en curso de un proceso que regresa del swap.
+ * Un proceso en esa situacion ya tiene memoria aunque siga en SWAPPED.
+ * @param process El proceso.
+ * @return true si tenia una lectura en curso y quedo en la memoria, false en caso contrario.
+ * */
+bool swap_in_finish(Process *process) {
+    if (swap_area == NULL || process->state != SWAPPED || entry_of(process->pid)->swapped) {
+        return false;
+    }
+    return swap_in(process);
+}
+
+/**
+ * Esta funcion regresa un proceso del swap y espera a que sus bytes esten en
+ * la memoria. El tiempo de espera se cuenta como tiempo detenido del proceso.
+ * @param process El proceso.
+ * @return true si el proceso quedo en la memoria, false en caso contrario.
+ * */
+bool swap_in(Process *process) {
+    if (!swap_in_start(process)) {
+        return false;
+    }
+    SwapEntry *entry = entry_of(process->pid);
+    entry->stall += wait_request(entry);
+    if (memory->backing != NULL) {
+        memcpy(memory->backing->bytes + base_of(process), entry->request.buffer, process->size);
+    }
+    free(entry->request.buffer);
+    entry->swap_ins++;
+    entry->bytes_in += process->size;
+    process->state = READY;
+    return true;
+}
+
+/**
+ * Esta funcion olvida un proceso que deja de existir: espera su ultima operacion,
+ * deja libre su espacio del archivo y borra su registro de swap. Si se estaba
+ * leyendo, la memoria que ya tenia asignada se libera aparte.
+ * @param process El proceso.
+ * */
+void swap_release(Process *process) {
+    if (swap_area == NULL) {
+        return;
+    }
+    int index = hash_get(swap_area->entry_of, process->pid);
+    if (index == NOT_FOUND) {
+        return;
+    }
+    SwapEntry *entry = swap_area->entries[index];
+    bool reading = entry->pending && !entry->request.write;
+    wait_request(entry);
+    if (reading) {
+        free(entry->request.buffer);
+    }
+    release_extent(entry);
+
+    // El ultimo registro ocupa el lugar del que se borra.
+    SwapEntry *last = swap_area->entries[--swap_area->num_entries];
+    swap_area->entries[index] = last;
+    hash_put(swap_area->entry_of, last->pid, index);
+    hash_remove(swap_area->entry_of, process->pid);
+    free(entry);
+}
+
+/**
+ * Esta funcion registra que el planificador ejecuta un proceso; los procesos
+ * ejecutados hace mas tiempo salen primero de la memoria.
+ * */
+void swap_touch(Process *process) {
+    if (swap_area != NULL) {
+        entry_of(process->pid)->last_used = ++swap_area->clock;
+    }
+}
+
+/**
+ * Esta funcion activa el swap en un archivo, que se crea o se vacia.
+ * @param path El archivo de swap.
+ * @param num_threads El numero de hilos de entrada/salida.
+ * @return true si se abrio el archivo, false en caso contrario.
+ * */
+bool enable_swap(char *path, int num_threads) {
+    if (swap_area != NULL) {
+        printf("Swap is already on, use swap off first\n");
+        return false;
+    }
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        printf("Could not open %s\n", path);
+        return false;
+    }
+
+    swap_area = (SwapArea *) calloc(1, sizeof(SwapArea));
+    swap_area->fd = fd;
+    swap_area->path = strdup(path);
+    swap_area->extents_capacity = 16;
+    swap_area->extents = (SwapExtent *) malloc(swap_area->extents_capacity * sizeof(SwapExtent));
+    swap_area->entries_capacity = 64;
+    swap_area->entries = (SwapEntry **) malloc(swap_area->entries_capacity * sizeof(SwapEntry *));
+    swap_area->entry_of = create_hash(64);
+    pthread_mutex_init(&swap_area->lock, NULL);
+    pthread_cond_init(&swap_area->work, NULL);
+    pthread_cond_init(&swap_area->finished, NULL);
+    swap_area->num_threads = num_threads;
+    swap_area->threads = (pthread_t *) malloc(num_threads * sizeof(pthread_t));
+    for (int i = 0; i < num_threads; i++) {
+        pthread_create(&swap_area->threads[i], NULL, run_io_thread, NULL);
+    }
+    return true;
+}
+
+/**
+ * Esta funcion desactiva el swap: espera las operaciones pendientes, detiene
+ * los hilos y cierra el archivo. Los procesos que estaban en el swap pierden
+ * su memoria y regresan al estado NEW.
+ * @param queue La cola de procesos.
+ * */
+void disable_swap(Queue *queue) {
+    if (swap_area == NULL) {
+        return;
+    }
+    for (int i = 0; i < swap_area->num_entries; i++) {
+        SwapEntry *entry = swap_area->entries[i];
+        bool reading = entry->pending && !entry->request.write;
+        wait_request(entry);
+        if (reading) {
+            free(entry->request.buffer);
+        }
+    }
+    for (Node *node = queue->head; node != NULL; node = (Node *) node->next) {
+        Process *process = (Process *) node->data;
+        if (process->state == SWAPPED) {
+            // Un proceso que se estaba leyendo ya tiene memoria, pero no sus bytes.
+            free_memory(process->pid);
+            process->state = NEW;
+        }
+    }
+
+    pthread_mutex_lock(&swap_area->lock);
+    swap_area->stopping = true;
+    pthread_cond_broadcast(&swap_area->work);
+    pthread_mutex_unlock(&swap_area->lock);
+    for (int i = 0; i < swap_area->num_threads; i++) {
+        pthread_join(swap_area->threads[i], NULL);
+    }
+
+    for (int i = 0; i < swap_area->num_entries; i++) {
+        free(swap_area->entries[i]);
+    }
+    close(swap_area->fd);
+    pthread_mutex_destroy(&swap_area->lock);
+    pthread_cond_destroy(&swap_area->work);
+    pthread_cond_destroy(&swap_area->finished);
+    clear_hash(swap_area->entry_of);
+    free(swap_area->entries);
+    free(swap_area->extents);
+    free(swap_area->threads);
+    free(swap_area->path);
+    free(swap_area);
+    swap_area = NULL;
+}
+
+/**
+ * Esta funcion imprime el trafico de swap y el tiempo detenido de cada proceso
+ * que paso por el swap, y el total.
+ * */
+void report_swap() {
+    if (swap_area == NULL) {
+        printf("Swap is off\n");
+        return;
+    }
+    printf("Swap file %s: %ld bytes, %d free extents, %d I/O threads\n", swap_area->path,
+           swap_area->end, swap_area->num_extents, swap_area->num_threads);
+    printf("%-8s %-8s %-8s %-14s %-14s %s\n", "PID", "Outs", "Ins", "Bytes out", "Bytes in", "Stall ms");
+
+    long bytes_out = 0, bytes_in = 0;
+    double stall = 0;
+    for (int i = 0; i < swap_area->num_entries; i++) {
+        SwapEntry *entry = swap_area->entries[i];
+        if (entry->swap_outs == 0) {
+            continue;
+        }
+        printf("%-8d %-8ld %-8ld %-14ld %-14ld %.3f%s\n", entry->pid, entry->swap_outs,
+               entry->swap_ins, entry->bytes_out, entry->bytes_in, entry->stall * 1e3,
+               entry->swapped ? " (swapped)" : "");
+        bytes_out += entry->bytes_out;
+        bytes_in += entry->bytes_in;
+        stall += entry->stall;
+    }
+
+    pthread_mutex_lock(&swap_area->lock);
+    double io_seconds = swap_area->io_seconds;
+    pthread_mutex_unlock(&swap_area->lock);
+    printf("Total: %ld bytes out, %ld bytes in, I/O %.3f ms, stalled %.3f ms (%.0f%% overlapped)\n",
+           bytes_out, bytes_in, io_seconds * 1e3, stall * 1e3,
+           io_seconds > stall && io_seconds > 0 ? 100.0 * (io_seconds - stall) / io_seconds : 0.0);
+}
@@ -0,0 +1,136 @@
+//
+// Created by yaelao on 6/20/23.
+//
+
+#ifndef SHELL_SWAP_H
+#define SHELL_SWAP_H
+
+#include <pthread.h>
+#include <time.h>
+#include "Memory.h"
+#include "Queue.h"
+
+// Numero de hilos de entrada/salida si no se indica otro.
+#define DEFAULT_SWAP_THREADS 2
+
+/**
+ * Estructura que representa una lectura o escritura del archivo de swap que
+ * hace un hilo de entrada/salida.
+ * @param write true para escribir en el archivo, false para leer.
+ * @param buffer Los bytes del proceso.
+ * @param size El numero de bytes.
+ * @param offset La posicion en el archivo.
+ * @param done true cuando el hilo termino la operacion.
+ * @param failed true si la operacion no se pudo completar.
+ * @param seconds El tiempo de la operacion.
+ * @param next La siguiente operacion en la cola de los hilos.
+ * */
+typedef struct SwapRequest {
+    bool write;
+    unsigned char *buffer;
+    long size;
+    long offset;
+    bool done;
+    bool failed;
+    double seconds;
+    struct SwapRequest *next;
+} SwapRequest;
+
+/**
+ * Estructura que representa un proceso que paso por el swap.
+ * @param pid El identificador del proceso.
+ * @param offset La posicion de su espacio en el archivo de swap.
+ * @param capacity El tamaño de su espacio en el archivo, 0 si no tiene.
+ * @param swapped true si sus bytes estan en el archivo y no en la memoria.
+ * @param pending true si su ultima operacion no se ha recogido.
+ * @param request Su ultima operacion.
+ * @param last_used El momento en que el planificador lo ejecuto por ultima vez.
+ * @param swap_outs El numero de veces que salio de la memoria.
+ * @param swap_ins El numero de veces que regreso a la memoria.
+ * @param bytes_out El total de bytes escritos al archivo.
+ * @param bytes_in El total de bytes leidos del archivo.
+ * @param stall El tiempo que el planificador espero sus operaciones, en segundos.
+ * */
+typedef struct {
+    int pid;
+    long offset;
+    long capacity;
+    bool swapped;
+    bool pending;
+    SwapRequest request;
+    long last_used;
+    long swap_outs;
+    long swap_ins;
+    long bytes_out;
+    long bytes_in;
+    double stall;
+} SwapEntry;
+
+/**
+ * Estructura que representa un espacio libre del archivo de swap.
+ * */
+typedef struct {
+    long offset;
+    long size;
+} SwapExtent;
+
+/**
+ * Estructura que representa el area de swap: un archivo donde se guardan los
+ * bytes de los procesos que se sacan de la memoria, y los hilos que lo leen y
+ * escriben con pread/pwrite mientras el planificador sigue trabajando.
+ * @param fd El archivo de swap.
+ * @param path El nombre del archivo.
+ * @param end El tamaño usado del archivo.
+ * @param extents Los espacios libres del archivo.
+ * @param num_extents El numero de espacios libres.
+ * @param extents_capacity El numero de espacios que caben en extents.
+ * @param entries Los procesos que pasaron por el swap o que el planificador ejecuto.
+ * @param num_entries El numero de procesos.
+ * @param entries_capacity El numero de procesos que caben en entries.
+ * @param entry_of El indice de cada proceso en entries, por pid.
+ * @param clock Avanza cada vez que el planificador ejecuta un proceso.
+ * @param threads Los hilos de entrada/salida.
+ * @param num_threads El numero de hilos.
+ * @param lock El candado de la cola de operaciones.
+ * @param work Avisa a los hilos que hay operaciones.
+ * @param finished Avisa al planificador que termino una operacion.
+ * @param head La primera operacion de la cola.
+ * @param tail La ultima operacion de la cola.
+ * @param stopping true cuando los hilos deben terminar.
+ * @param io_seconds El tiempo total de las operaciones.
+ * */
+typedef struct {
+    int fd;
+    char *path;
+    long end;
+    SwapExtent *extents;
+    int num_extents;
+    int extents_capacity;
+    SwapEntry **entries;
+    int num_entries;
+    int entries_capacity;
+    HashMap *entry_of;
+    long clock;
+    pthread_t *threads;
+    int num_threads;
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    pthread_cond_t finished;
+    SwapRequest *head;
+    SwapRequest *tail;
+    bool stopping;
+    double io_seconds;
+} SwapArea;
+
+extern SwapArea *swap_area;
+
+bool enable_swap(char *path, int num_threads);
+void disable_swap(Queue *queue);
+long allocate_with_swap(Process *process, char *fit);
+bool swap_in_start(Process *process);
+bool swap_in(Process *process);
+bool swap_in_finish(Process *process);
+void swap_release(Process *process);
+void swap_touch(Process *process);
+void report_swap();
+#endif //SHELL_SWAP_H
@@ -0,0 +1,144 @@
+//
+// Created by yaelao on 6/7/23.
+//
+
+#include "Table.h"
+
+/**
+ * Crea una tabla de bloques vacia.
+ * @param capacity El numero inicial de bloques que caben en la tabla.
+ * @return La tabla creada.
+ * */
+BlockTable *create_table(int capacity) {
+    BlockTable *table = (BlockTable *) malloc(sizeof(BlockTable));
+    table->capacity = capacity > 0 ? capacity : 1;
+    table->slots = (MemoryBlock *) malloc(table->capacity * sizeof(MemoryBlock));
+    table->used = 0;
+    table->free_slot = NO_BLOCK;
+    table->head = NO_BLOCK;
+    table->tail = NO_BLOCK;
+    table->size = 0;
+    return table;
+}
+
+/**
+ * Comprueba si la tabla esta vacia.
+ * */
+bool is_table_empty(BlockTable *table) {
+    return table->size == 0;
+}
+
+/**
+ * Obtiene una posicion libre del arreglo, reutilizando las posiciones
+ * de bloques removidos antes de crecer el arreglo.
+ * @param table La tabla.
+ * @return El indice de la posicion obtenida.
+ * */
+static int take_slot(BlockTable *table) {
+    if (table->free_slot != NO_BLOCK) {
+        int index = table->free_slot;
+        table->free_slot = table->slots[index].next;
+        return index;
+    }
+
+    if (table->used == table->capacity) {
+        table->capacity *= 2;
+        table->slots = (MemoryBlock *) realloc(table->slots,
+                                               table->capacity * sizeof(MemoryBlock));
+    }
+    return table->used++;
+}
+
+/**
+ * Agrega un bloque vacio despues del bloque indicado en O(1).
+ * @param table La tabla.
+ * @param index El indice del bloque anterior, NO_BLOCK para agregarlo al inicio.
+ * @return El indice del bloque agregado.
+ * */
+int table_insert_after(BlockTable *table, int index) {
+    int slot = take_slot(table);
+    MemoryBlock *block = &table->slots[slot];
+    block->base = 0;
+    block->size = 0;
+    block->process = NULL;
+    block->free_node = NULL;
+    block->free_previous = NO_BLOCK;
+    block->free_next = NO_BLOCK;
+    block->previous = index;
+
+    if (index == NO_BLOCK) {
+        block->next = table->head;
+        table->head = slot;
+    } else {
+        block->next = table->slots[index].next;
+        table->slots[index].next = slot;
+    }
+
+    if (block->next == NO_BLOCK) {
+        table->tail = slot;
+    } else {
+        table->slots[block->next].previous = slot;
+    }
+    table->size++;
+    return slot;
+}
+
+/**
+ * Remueve un bloque de la tabla en O(1). Su posicion queda disponible.
+ * @param table La tabla.
+ * @param index El indice del bloque a remover.
+ * */
+void table_remove(BlockTable *table, int index) {
+    MemoryBlock *block = &table->slots[index];
+
+    if (block->previous == NO_BLOCK) {
+        table->head = block->next;
+    } else {
+        table->slots[block->previous].next = block->next;
+    }
+    if (block->next == NO_BLOCK) {
+        table->tail = block->previous;
+    } else {
+        table->slots[block->next].previous = block->previous;
+    }
+
+    block->next = table->free_slot;
+    table->free_slot = index;
+    table->size--;
+}
+
+/**
+ * Reacomoda el arreglo para que los bloques queden en orden de direccion,
+ * de modo que recorrer la tabla sea un recorrido secuencial del arreglo.
+ * Los indices de los bloques cambian: el bloque n-esimo queda en la posicion n.
+ * @param table La tabla a reacomodar.
+ * */
+void table_repack(BlockTable *table) {
+    MemoryBlock *slots = (MemoryBlock *) malloc(table->capacity * sizeof(MemoryBlock));
+    int position = 0;
+
+    for (int i = table->head; i != NO_BLOCK; i = table->slots[i].next, position++) {
+        slots[position] = table->slots[i];
+        slots[position].previous = position - 1;
+        slots[position].next = position + 1;
+    }
+    if (position > 0) {
+        slots[position - 1].next = NO_BLOCK;
+    }
+
+    free(table->slots);
+    table->slots = slots;
+    table->used = position;
+    table->free_slot = NO_BLOCK;
+    table->head = position > 0 ? 0 : NO_BLOCK;
+    table->tail = position - 1;
+}
+
+/**
+ * Libera la memoria reservada para la tabla.
+ * @param table La tabla a liberar.
+ * */
+void clear_table(BlockTable *table) {
+    free(table->slots);
+    free(table);
+}
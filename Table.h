@@ -0,0 +1,77 @@
+//
+// Created by yaelao on 6/7/23.
+//
+
+#ifndef SHELL_TABLE_H
+#define SHELL_TABLE_H
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "Process.h"
+#include "Tree.h"
+
+// Indice que representa la ausencia de un bloque.
+#define NO_BLOCK (-1)
+
+/**
+ * Estructura que representa un bloque de memoria dentro de la tabla.
+ * El limite y el espacio restante se calculan a partir de base, size y process.
+ * @param base La direccion donde inicia el bloque.
+ * @param size El tamaño del bloque.
+ * @param process El proceso asignado al bloque, NULL si esta libre.
+ * @param previous El indice del bloque anterior en orden de direccion.
+ * @param next El indice del bloque siguiente en orden de direccion.
+ * @param free_node El nodo del bloque en el indice de bloques libres.
+ * @param free_previous El bloque libre anterior en la lista de su clase de tamaño.
+ * @param free_next El bloque libre siguiente en la lista de su clase de tamaño.
+ * */
+typedef struct {
+    long base;
+    long size;
+    Process *process;
+    int previous;
+    int next;
+    TreeNode *free_node;
+    int free_previous;
+    int free_next;
+} MemoryBlock;
+
+/**
+ * Estructura que representa la tabla de bloques de memoria.
+ * Los bloques viven en un solo arreglo contiguo que crece al doble cuando se llena;
+ * el orden por direccion se mantiene enlazando los indices de los bloques.
+ * @param slots El arreglo de bloques.
+ * @param capacity El numero de bloques que caben en el arreglo.
+ * @param used El numero de posiciones del arreglo que se han usado alguna vez.
+ * @param free_slot La primera posicion liberada que se puede reutilizar.
+ * @param head El indice del primer bloque.
+ * @param tail El indice del ultimo bloque.
+ * @param size El numero de bloques en la tabla.
+ * */
+typedef struct {
+    MemoryBlock *slots;
+    int capacity;
+    int used;
+    int free_slot;
+    int head;
+    int tail;
+    int size;
+} BlockTable;
+
+BlockTable *create_table(int capacity);
+void clear_table(BlockTable *table);
+int table_insert_after(BlockTable *table, int index);
+void table_remove(BlockTable *table, int index);
+void table_repack(BlockTable *table);
+bool is_table_empty(BlockTable *table);
+
+/**
+ * Obtiene el bloque en el indice indicado en O(1).
+ * El apuntador deja de ser valido cuando se inserta un bloque en la tabla.
+ * */
+static inline MemoryBlock *block_at(BlockTable *table, int index) {
+    return &table->slots[index];
+}
+#endif //SHELL_TABLE_H
@@ -0,0 +1,171 @@
+//
+// Created by yaelao on 6/9/23.
+//
+
+#include "Tlsf.h"
+
+/**
+ * Obtiene la lista segregada a la que pertenece un bloque libre de un tamaño.
+ * Los tamaños menores a TLSF_SL tienen una lista cada uno; los demas se agrupan
+ * por su potencia de dos (primer nivel) y por los siguientes TLSF_SL_BITS bits
+ * (segundo nivel).
+ * @param size El tamaño del bloque.
+ * @param first_level Donde se guarda el indice de primer nivel.
+ * @param second_level Donde se guarda el indice de segundo nivel.
+ * */
+static void mapping_insert(long size, int *first_level, int *second_level) {
+    if (size < TLSF_SL) {
+        *first_level = 0;
+        *second_level = (int) size;
+        return;
+    }
+
+    int log = 63 - __builtin_clzl((unsigned long) size);
+    *first_level = log - TLSF_SL_BITS + 1;
+    *second_level = (int) (size >> (log - TLSF_SL_BITS)) ^ TLSF_SL;
+}
+
+/**
+ * Obtiene la primera lista donde cualquier bloque alcanza para un tamaño,
+ * redondeando el tamaño hacia arriba al inicio de la siguiente lista.
+ * */
+static void mapping_search(long size, int *first_level, int *second_level) {
+    if (size >= TLSF_SL) {
+        int log = 63 - __builtin_clzl((unsigned long) size);
+        size += (1L << (log - TLSF_SL_BITS)) - 1;
+    }
+    mapping_insert(size, first_level, second_level);
+}
+
+/**
+ * Agrega un bloque libre al inicio de su lista segregada en O(1).
+ * @param block_index El indice del bloque.
+ * */
+void tlsf_insert(int block_index) {
+    MemoryBlock *block = block_at(memory->blocks, block_index);
+    int first_level, second_level;
+    mapping_insert(block->size, &first_level, &second_level);
+    int head = memory->tlsf_lists[first_level][second_level];
+
+    block->free_previous = NO_BLOCK;
+    block->free_next = head;
+    if (head != NO_BLOCK) {
+        block_at(memory->blocks, head)->free_previous = block_index;
+    }
+    memory->tlsf_lists[first_level][second_level] = block_index;
+    memory->tlsf_first |= 1UL << first_level;
+    memory->tlsf_second[first_level] |= 1U << second_level;
+}
+
+/**
+ * Remueve un bloque libre de su lista segregada en O(1).
+ * @param block_index El indice del bloque.
+ * @return true si el bloque estaba en la lista, false en caso contrario.
+ * */
+bool tlsf_remove(int block_index) {
+    MemoryBlock *block = block_at(memory->blocks, block_index);
+    int first_level, second_level;
+    mapping_insert(block->size, &first_level, &second_level);
+    int *head = &memory->tlsf_lists[first_level][second_level];
+
+    // El bloque no esta en ninguna lista.
+    if (block->free_previous == NO_BLOCK && *head != block_index) {
+        return false;
+    }
+
+    if (block->free_previous == NO_BLOCK) {
+        *head = block->free_next;
+    } else {
+        block_at(memory->blocks, block->free_previous)->free_next = block->free_next;
+    }
+    if (block->free_next != NO_BLOCK) {
+        block_at(memory->blocks, block->free_next)->free_previous = block->free_previous;
+    }
+    block->free_previous = NO_BLOCK;
+    block->free_next = NO_BLOCK;
+
+    if (*head == NO_BLOCK) {
+        memory->tlsf_second[first_level] &= ~(1U << second_level);
+        if (memory->tlsf_second[first_level] == 0) {
+            memory->tlsf_first &= ~(1UL << first_level);
+        }
+    }
+    return true;
+}
+
+/**
+ * Busca un bloque libre que alcance para un tamaño usando los mapas de bits,
+ * sin recorrer bloques.
+ * @param size El tamaño requerido.
+ * @return El indice del bloque, NO_BLOCK si no hay ninguno.
+ * */
+static int find_suitable_block(long size) {
+    int first_level, second_level;
+    mapping_search(size, &first_level, &second_level);
+    if (first_level >= TLSF_FL) {
+        return NO_BLOCK;
+    }
+
+    // Primero en la misma clase de primer nivel, despues en las mayores.
+    unsigned int second_map = memory->tlsf_second[first_level] & (~0U << second_level);
+    if (second_map == 0) {
+        unsigned long first_map = first_level + 1 < TLSF_FL
+                                  ? memory->tlsf_first & (~0UL << (first_level + 1)) : 0;
+        if (first_map == 0) {
+            return NO_BLOCK;
+        }
+        first_level = __builtin_ctzl(first_map);
+        second_map = memory->tlsf_second[first_level];
+    }
+    second_level = __builtin_ctz(second_map);
+    return memory->tlsf_lists[first_level][second_level];
+}
+
+/**
+ * Asigna un proceso a un bloque libre en tiempo constante.
+ * El sobrante del bloque se separa y se regresa a su lista.
+ * @param process El proceso a asignar.
+ * @return El indice del bloque asignado, NO_BLOCK si no hay espacio.
+ * */
+int tlsf_alloc(Process *process) {
+    int block_index = find_suitable_block(process->size);
+    if (block_index == NO_BLOCK) {
+        return NO_BLOCK;
+    }
+
+    unindex_free_block(block_index);
+    MemoryBlock *block = block_at(memory->blocks, block_index);
+    if (block->size > process->size) {
+        long remaining = block->size - process->size;
+        block->size = process->size;
+        make_memory_block(block_index, block->base + process->size, remaining);
+        block = block_at(memory->blocks, block_index);
+    }
+
+    block->process = process;
+    block->process->state = READY;
+    memory->allocated_blocks++;
+    hash_put(memory->owners, process->pid, block_index);
+    return block_index;
+}
+
+/**
+ * Obtiene una cota del tamaño del mayor bloque libre en O(1): los mapas de bits
+ * dan la mayor lista con bloques libres y se usa el mayor tamaño de esa lista,
+ * que excede al bloque real en menos de 1/TLSF_SL. Nunca es mayor que la memoria libre.
+ * @return La cota, 0 si no hay bloques libres.
+ * */
+long tlsf_largest() {
+    if (memory->tlsf_first == 0) {
+        return 0;
+    }
+    int first_level = 63 - __builtin_clzl(memory->tlsf_first);
+    int second_level = 31 - __builtin_clz(memory->tlsf_second[first_level]);
+    if (first_level == 0) {
+        return second_level;
+    }
+
+    long step = 1L << (first_level - 1);
+    long upper = (TLSF_SL + second_level) * step + (step - 1);
+    return upper < memory->remaining_size ? upper : memory->remaining_size;
+}
@@ -0,0 +1,14 @@
+//
+// Created by yaelao on 6/9/23.
+//
+
+#ifndef SHELL_TLSF_H
+#define SHELL_TLSF_H
+
+#include "Memory.h"
+
+void tlsf_insert(int block_index);
+bool tlsf_remove(int block_index);
+int tlsf_alloc(Process *process);
+long tlsf_largest();
+#endif //SHELL_TLSF_H
@@ -0,0 +1,406 @@
+//
+// Created by yaelao on 6/6/23.
+//
+
+#include "Tree.h"
+
+/**
+ * Crea un arbol vacio.
+ * @return El arbol creado.
+ * */
+Tree *create_tree() {
+    Tree *tree = (Tree *) malloc(sizeof(Tree));
+    tree->root = NULL;
+    tree->first = NULL;
+    tree->last = NULL;
+    tree->size = 0;
+    return tree;
+}
+
+/**
+ * Comprueba si el arbol esta vacio.
+ * @param tree El arbol a comprobar.
+ * @return true si el arbol esta vacio, false en caso contrario.
+ * */
+bool is_tree_empty(Tree *tree) {
+    return tree->size == 0;
+}
+
+/**
+ * Rota un nodo hacia la izquierda.
+ * @param tree El arbol al que pertenece el nodo.
+ * @param node El nodo a rotar.
+ * */
+static void rotate_left(Tree *tree, TreeNode *node) {
+    TreeNode *right = node->right;
+    TreeNode *parent = node->parent;
+
+    node->right = right->left;
+    if (right->left != NULL) {
+        right->left->parent = node;
+    }
+    right->left = node;
+    right->parent = parent;
+
+    if (parent == NULL) {
+        tree->root = right;
+    } else if (parent->left == node) {
+        parent->left = right;
+    } else {
+        parent->right = right;
+    }
+    node->parent = right;
+}
+
+/**
+ * Rota un nodo hacia la derecha.
+ * @param tree El arbol al que pertenece el nodo.
+ * @param node El nodo a rotar.
+ * */
+static void rotate_right(Tree *tree, TreeNode *node) {
+    TreeNode *left = node->left;
+    TreeNode *parent = node->parent;
+
+    node->left = left->right;
+    if (left->right != NULL) {
+        left->right->parent = node;
+    }
+    left->right = node;
+    left->parent = parent;
+
+    if (parent == NULL) {
+        tree->root = left;
+    } else if (parent->right == node) {
+        parent->right = left;
+    } else {
+        parent->left = left;
+    }
+    node->parent = left;
+}
+
+static bool is_black(TreeNode *node) {
+    return node == NULL || !node->is_red;
+}
+
+/**
+ * Restaura las propiedades del arbol despues de insertar un nodo.
+ * @param tree El arbol.
+ * @param node El nodo insertado.
+ * */
+static void insert_color(Tree *tree, TreeNode *node) {
+    TreeNode *parent;
+
+    while ((parent = node->parent) != NULL && parent->is_red) {
+        TreeNode *grandparent = parent->parent;
+
+        if (parent == grandparent->left) {
+            TreeNode *uncle = grandparent->right;
+            if (!is_black(uncle)) {
+                uncle->is_red = false;
+                parent->is_red = false;
+                grandparent->is_red = true;
+                node = grandparent;
+                continue;
+            }
+            if (parent->right == node) {
+                rotate_left(tree, parent);
+                TreeNode *temp = parent;
+                parent = node;
+                node = temp;
+            }
+            parent->is_red = false;
+            grandparent->is_red = true;
+            rotate_right(tree, grandparent);
+        } else {
+            TreeNode *uncle = grandparent->left;
+            if (!is_black(uncle)) {
+                uncle->is_red = false;
+                parent->is_red = false;
+                grandparent->is_red = true;
+                node = grandparent;
+                continue;
+            }
+            if (parent->left == node) {
+                rotate_right(tree, parent);
+                TreeNode *temp = parent;
+                parent = node;
+                node = temp;
+            }
+            parent->is_red = false;
+            grandparent->is_red = true;
+            rotate_left(tree, grandparent);
+        }
+    }
+    tree->root->is_red = false;
+}
+
+/**
+ * Inserta un nodo en el arbol.
+ * Las llaves repetidas se insertan a la derecha de las existentes.
+ * @param tree El arbol.
+ * @param key La llave del nodo.
+ * @param data El dato que contendra el nodo.
+ * @return El nodo insertado, necesario para removerlo despues.
+ * */
+TreeNode *tree_insert(Tree *tree, long key, void *data) {
+    TreeNode *node = (TreeNode *) malloc(sizeof(TreeNode));
+    node->key = key;
+    node->data = data;
+    node->is_red = true;
+    node->left = NULL;
+    node->right = NULL;
+
+    TreeNode *parent = NULL;
+    TreeNode **link = &tree->root;
+    while (*link != NULL) {
+        parent = *link;
+        link = key < parent->key ? &parent->left : &parent->right;
+    }
+    node->parent = parent;
+    *link = node;
+
+    if (tree->first == NULL || key < tree->first->key) {
+        tree->first = node;
+    }
+    if (tree->last == NULL || key >= tree->last->key) {
+        tree->last = node;
+    }
+    tree->size++;
+
+    insert_color(tree, node);
+    return node;
+}
+
+/**
+ * Restaura las propiedades del arbol despues de remover un nodo negro.
+ * @param tree El arbol.
+ * @param node El nodo que ocupo el lugar del nodo removido (puede ser NULL).
+ * @param parent El padre de node.
+ * */
+static void remove_color(Tree *tree, TreeNode *node, TreeNode *parent) {
+    TreeNode *sibling;
+
+    while (is_black(node) && node != tree->root) {
+        if (parent->left == node) {
+            sibling = parent->right;
+            if (!is_black(sibling)) {
+                sibling->is_red = false;
+                parent->is_red = true;
+                rotate_left(tree, parent);
+                sibling = parent->right;
+            }
+            if (is_black(sibling->left) && is_black(sibling->right)) {
+                sibling->is_red = true;
+                node = parent;
+                parent = node->parent;
+            } else {
+                if (is_black(sibling->right)) {
+                    sibling->left->is_red = false;
+                    sibling->is_red = true;
+                    rotate_right(tree, sibling);
+                    sibling = parent->right;
+                }
+                sibling->is_red = parent->is_red;
+                parent->is_red = false;
+                sibling->right->is_red = false;
+                rotate_left(tree, parent);
+                node = tree->root;
+                break;
+            }
+        } else {
+            sibling = parent->left;
+            if (!is_black(sibling)) {
+                sibling->is_red = false;
+                parent->is_red = true;
+                rotate_right(tree, parent);
+                sibling = parent->left;
+            }
+            if (is_black(sibling->left) && is_black(sibling->right)) {
+                sibling->is_red = true;
+                node = parent;
+                parent = node->parent;
+            } else {
+                if (is_black(sibling->left)) {
+                    sibling->right->is_red = false;
+                    sibling->is_red = true;
+                    rotate_left(tree, sibling);
+                    sibling = parent->left;
+                }
+                sibling->is_red = parent->is_red;
+                parent->is_red = false;
+                sibling->left->is_red = false;
+                rotate_right(tree, parent);
+                node = tree->root;
+                break;
+            }
+        }
+    }
+    if (node != NULL) {
+        node->is_red = false;
+    }
+}
+
+/**
+ * Reemplaza un nodo por otro en el enlace de su padre.
+ * */
+static void replace_child(Tree *tree, TreeNode *parent, TreeNode *old, TreeNode *new) {
+    if (parent == NULL) {
+        tree->root = new;
+    } else if (parent->left == old) {
+        parent->left = new;
+    } else {
+        parent->right = new;
+    }
+}
+
+/**
+ * Remueve un nodo del arbol y libera su memoria.
+ * @param tree El arbol.
+ * @param node El nodo a remover, obtenido de tree_insert.
+ * */
+void tree_remove(Tree *tree, TreeNode *node) {
+    TreeNode *child, *parent;
+    bool was_red;
+
+    if (node == tree->first) {
+        tree->first = tree_next(node);
+    }
+    if (node == tree->last) {
+        tree->last = tree_previous(node);
+    }
+
+    if (node->left != NULL && node->right != NULL) {
+        // Se reemplaza el nodo por su sucesor.
+        TreeNode *successor = node->right;
+        while (successor->left != NULL) {
+            successor = successor->left;
+        }
+        replace_child(tree, node->parent, node, successor);
+
+        child = successor->right;
+        parent = successor->parent;
+        was_red = successor->is_red;
+
+        if (parent == node) {
+            parent = successor;
+        } else {
+            if (child != NULL) {
+                child->parent = parent;
+            }
+            parent->left = child;
+            successor->right = node->right;
+            node->right->parent = successor;
+        }
+        successor->parent = node->parent;
+        successor->is_red = node->is_red;
+        successor->left = node->left;
+        node->left->parent = successor;
+    } else {
+        child = node->left != NULL ? node->left : node->right;
+        parent = node->parent;
+        was_red = node->is_red;
+
+        if (child != NULL) {
+            child->parent = parent;
+        }
+        replace_child(tree, parent, node, child);
+    }
+
+    if (!was_red) {
+        remove_color(tree, child, parent);
+    }
+    tree->size--;
+    free(node);
+}
+
+/**
+ * Busca el primer nodo cuya llave sea mayor o igual a la indicada.
+ * @param tree El arbol.
+ * @param key La llave a buscar.
+ * @return El nodo encontrado, NULL si todas las llaves son menores.
+ * */
+TreeNode *tree_lower_bound(Tree *tree, long key) {
+    TreeNode *current = tree->root;
+    TreeNode *found = NULL;
+
+    while (current != NULL) {
+        if (current->key >= key) {
+            found = current;
+            current = current->left;
+        } else {
+            current = current->right;
+        }
+    }
+    return found;
+}
+
+/**
+ * Obtiene el nodo con la menor llave en O(1).
+ * */
+TreeNode *tree_first(Tree *tree) {
+    return tree->first;
+}
+
+/**
+ * Obtiene el nodo con la mayor llave en O(1).
+ * */
+TreeNode *tree_last(Tree *tree) {
+    return tree->last;
+}
+
+/**
+ * Obtiene el siguiente nodo en orden.
+ * @param node El nodo actual.
+ * @return El siguiente nodo, NULL si es el ultimo.
+ * */
+TreeNode *tree_next(TreeNode *node) {
+    if (node->right != NULL) {
+        node = node->right;
+        while (node->left != NULL) {
+            node = node->left;
+        }
+        return node;
+    }
+    while (node->parent != NULL && node == node->parent->right) {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+/**
+ * Obtiene el nodo anterior en orden.
+ * @param node El nodo actual.
+ * @return El nodo anterior, NULL si es el primero.
+ * */
+TreeNode *tree_previous(TreeNode *node) {
+    if (node->left != NULL) {
+        node = node->left;
+        while (node->right != NULL) {
+            node = node->right;
+        }
+        return node;
+    }
+    while (node->parent != NULL && node == node->parent->left) {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+static void clear_nodes(TreeNode *node) {
+    while (node != NULL) {
+        TreeNode *left = node->left;
+        clear_nodes(node->right);
+        free(node);
+        node = left;
+    }
+}
+
+/**
+ * Libera la memoria reservada para el arbol.
+ * Los datos de los nodos no se liberan.
+ * @param tree El arbol a liberar.
+ * */
+void clear_tree(Tree *tree) {
+    clear_nodes(tree->root);
+    free(tree);
+}
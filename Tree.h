@@ -0,0 +1,54 @@
+//
+// Created by yaelao on 6/6/23.
+//
+
+#ifndef SHELL_TREE_H
+#define SHELL_TREE_H
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * Estructura que representa un nodo del arbol rojo-negro.
+ * @param key La llave por la que se ordena el nodo.
+ * @param data El dato que contiene el nodo.
+ * @param is_red El color del nodo.
+ * @param left El hijo izquierdo.
+ * @param right El hijo derecho.
+ * @param parent El padre del nodo.
+ * */
+typedef struct TreeNode {
+    long key;
+    void *data;
+    bool is_red;
+    struct TreeNode *left;
+    struct TreeNode *right;
+    struct TreeNode *parent;
+} TreeNode;
+
+/**
+ * Estructura que representa un arbol rojo-negro ordenado por llave.
+ * Se permiten llaves repetidas; las iguales se ordenan por orden de insercion.
+ * @param root La raiz del arbol.
+ * @param first El nodo con la menor llave (se mantiene en cache).
+ * @param last El nodo con la mayor llave (se mantiene en cache).
+ * @param size El numero de nodos en el arbol.
+ * */
+typedef struct {
+    TreeNode *root;
+    TreeNode *first;
+    TreeNode *last;
+    int size;
+} Tree;
+
+Tree *create_tree();
+void clear_tree(Tree *tree);
+TreeNode *tree_insert(Tree *tree, long key, void *data);
+void tree_remove(Tree *tree, TreeNode *node);
+TreeNode *tree_lower_bound(Tree *tree, long key);
+TreeNode *tree_first(Tree *tree);
+TreeNode *tree_last(Tree *tree);
+TreeNode *tree_next(TreeNode *node);
+TreeNode *tree_previous(TreeNode *node);
+bool is_tree_empty(Tree *tree);
+#endif //SHELL_TREE_H
@@ -5,9 +5,35 @@
 #include "Memory.h"
 #include "Prompt.h"
 
-int main() {
+int main(int argc, char *argv[]) {
+    long memory_size = DEFAULT_MEMORY_SIZE;
+    char *replay_fit = NULL, *replay_source = NULL;
+    bool valid = true;
 
-    init_shell();
+    // Uso: ./Shell [--size <tamaño>] [--replay <algoritmo> <traza>], por ejemplo --size 16G.
+    for (int i = 1; i < argc && valid; i++) {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            memory_size = parse_size(argv[++i]);
+            valid = memory_size >= 0;
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 2 < argc) {
+            replay_fit = argv[++i];
+            replay_source = argv[++i];
+        } else {
+            valid = false;
+        }
+    }
+    if (!valid) {
+        fprintf(stderr, "Usage: %s [--size <size>[K|M|G|T]] [--replay <fit> <file|churn:<events>[:<seed>[:<uniform|exp|pareto>]]>]\n",
+                argv[0]);
+        return 1;
+    }
+
+    init_shell(memory_size);
+
+    // Con --replay se reproduce la traza y se termina sin mostrar el prompt.
+    if (replay_fit != NULL) {
+        return replay_trace(replay_fit, replay_source) ? 0 : 1;
+    }
 
     while(true)
        show_prompt();